@@ -1,6 +1,36 @@
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstdio>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Descriptor I/O for FdGuard and AsyncWriter (O_DIRECT, posix_fallocate, sync_file_range,
+// io_uring): Linux only. FileGuard and its buffered mode are portable.
+#if defined(__linux__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
 
 /*
 RAII: Resource Acquisition Is Initialization
@@ -10,8 +40,51 @@ Key Concepts:
 - Move Constructor: https://en.cppreference.com/w/cpp/language/move_constructor
 - Move Assignment: https://en.cppreference.com/w/cpp/language/move_assignment
 - Deleted Functions (= delete): https://en.cppreference.com/w/cpp/language/function#Deleted_functions
+
+Buffered writing: after use_buffer(), write() appends records to a caller-provided,
+page-aligned buffer with a plain memcpy (no stdio call, so no per-record FILE lock) and the
+buffer goes to the file in one unbuffered fwrite each time it fills, so the file is written
+in large page-aligned blocks. The guard owns the pending bytes: destruction and move
+assignment flush them before closing, a moved-from guard has nothing to flush or close.
+
+FdGuard is the same ownership over a raw descriptor, for bulk writers that need to control
+the page cache: O_DIRECT moves page-aligned blocks straight to the device (no copy, no dirty
+pages to flush later; odd-sized writes are staged into whole pages so the stream stays
+aligned), posix_fallocate reserves the extent up front, and in buffered mode
+sync_file_range + POSIX_FADV_DONTNEED keep writeback steady instead of letting dirty pages
+pile up until the kernel stalls the writer. FdGuard and AsyncWriter (with their tests and
+benches) are Linux only; FileGuard builds on every preset.
+
+AsyncWriter keeps the same lifecycle for a real-time loop that must never block on the file:
+write() only copies into a ring of buffers, full buffers are submitted to io_uring (or to a
+pwrite thread) and finished ones are reaped by polling. The destructor is the one place that
+waits: it drains everything in flight before closing the descriptor.
+
+Run with --bench [MB] for records/s of 16..256-byte records against fputs, then sustained
+MB/s and per-write latency of FileGuard + fputs against both FdGuard modes (default 1024 MB), and the per-write stall percentiles of a paced hot loop
+on fputs and both AsyncWriter backends.
 */
 
+// Heap block aligned to `alignment` (a page by default), for FileGuard::use_buffer.
+class AlignedBuffer
+{
+public:
+    explicit AlignedBuffer(std::size_t size, std::size_t alignment = 4096);
+
+    std::span<std::byte> span() const;
+
+private:
+    // Aligned operator new rather than std::aligned_alloc, which MSVC's CRT lacks.
+    struct Free
+    {
+        std::size_t alignment;
+        void operator()(std::byte *p) const { ::operator delete(p, std::align_val_t{alignment}); }
+    };
+
+    std::unique_ptr<std::byte[], Free> data_;
+    std::size_t size_ = 0;
+};
+
 class FileGuard
 {
 public:
@@ -27,10 +100,41 @@ public:
     std::FILE *get() const;
     explicit operator bool() const;
 
+    // Switches to buffered writing through `buffer` (page-aligned address and size, which
+    // must outlive the guard or the next use_buffer call). Pending bytes in a previous buffer
+    // are flushed first. False if there is no file or the buffer is not page-aligned.
+    bool use_buffer(std::span<std::byte> buffer);
+
+    // Appends bytes; without a buffer this is a plain fwrite. False on a write error.
+    bool write(std::string_view bytes);
+
+    // Writes pending bytes and flushes the FILE. Call before using get() directly.
+    bool flush();
+
 private:
+    bool drain();
+    void close();
+
     std::FILE *file_ = nullptr;
+    std::span<std::byte> buffer_;
+    std::size_t used_ = 0;
 };
 
+constexpr std::size_t page_size = 4096;
+
+AlignedBuffer::AlignedBuffer(std::size_t size, std::size_t alignment)
+    : data_(static_cast<std::byte *>(::operator new((size + alignment - 1) / alignment * alignment,
+                                                    std::align_val_t{alignment}, std::nothrow)),
+            Free{alignment}),
+      size_(data_ ? size : 0)
+{
+}
+
+std::span<std::byte> AlignedBuffer::span() const
+{
+    return {data_.get(), size_};
+}
+
 FileGuard::FileGuard(const char *path, const char *mode)
 {
     file_ = std::fopen(path, mode);
@@ -38,14 +142,11 @@ FileGuard::FileGuard(const char *path, const char *mode)
 
 FileGuard::~FileGuard()
 {
-    if (file_)
-    {
-        std::fclose(file_);
-        file_ = nullptr;
-    }
+    close();
 }
 
-FileGuard::FileGuard(FileGuard &&other) noexcept : file_(other.file_)
+FileGuard::FileGuard(FileGuard &&other) noexcept
+    : file_(other.file_), buffer_(std::exchange(other.buffer_, {})), used_(std::exchange(other.used_, 0))
 {
     other.file_ = nullptr;
 }
@@ -54,13 +155,11 @@ FileGuard &FileGuard::operator=(FileGuard &&other) noexcept
 {
     if (this != &other)
     {
-        if (file_)
-        {
-            std::fclose(file_);
-            file_ = nullptr;
-        }
+        close();
         file_ = other.file_;
         other.file_ = nullptr;
+        buffer_ = std::exchange(other.buffer_, {});
+        used_ = std::exchange(other.used_, 0);
     }
     return *this;
 }
@@ -75,7 +174,1099 @@ FileGuard::operator bool() const
     return file_ != nullptr;
 }
 
-int main()
+bool FileGuard::use_buffer(std::span<std::byte> buffer)
+{
+    const bool aligned = reinterpret_cast<std::uintptr_t>(buffer.data()) % page_size == 0 &&
+                         buffer.size() % page_size == 0 && !buffer.empty();
+    if (!file_ || !aligned || !drain())
+        return false;
+
+    // Our buffer replaces stdio's: full blocks go straight to write(2).
+    std::fflush(file_);
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+    buffer_ = buffer;
+    used_ = 0;
+    return true;
+}
+
+bool FileGuard::write(std::string_view bytes)
+{
+    if (!file_)
+        return false;
+    if (buffer_.empty())
+        return std::fwrite(bytes.data(), 1, bytes.size(), file_) == bytes.size();
+
+    // Common case: the record fits in the space left.
+    if (bytes.size() < buffer_.size() - used_)
+    {
+        std::memcpy(buffer_.data() + used_, bytes.data(), bytes.size());
+        used_ += bytes.size();
+        return true;
+    }
+    while (!bytes.empty())
+    {
+        const std::size_t n = std::min(bytes.size(), buffer_.size() - used_);
+        std::memcpy(buffer_.data() + used_, bytes.data(), n);
+        used_ += n;
+        bytes.remove_prefix(n);
+        if (used_ == buffer_.size() && !drain())
+            return false;
+    }
+    return true;
+}
+
+bool FileGuard::flush()
+{
+    return file_ && drain() && std::fflush(file_) == 0;
+}
+
+bool FileGuard::drain()
+{
+    if (used_ == 0)
+        return true;
+    const std::size_t pending = std::exchange(used_, 0);
+    return std::fwrite(buffer_.data(), 1, pending, file_) == pending;
+}
+
+void FileGuard::close()
+{
+    if (file_)
+    {
+        drain();
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+    buffer_ = {};
+    used_ = 0;
+}
+
+#if defined(__linux__)
+
+// ---- File-descriptor guard ----
+
+struct FdOptions
+{
+    bool direct = false;          // O_DIRECT: bypass the page cache (falls back if the filesystem refuses)
+    std::uint64_t preallocate = 0; // posix_fallocate this many bytes up front (one extent, no ENOSPC mid-run)
+    std::uint64_t sync_every = 0;  // buffered mode: start writeback every N bytes and drop older pages (0 = never)
+};
+
+// Move-only owner of a write-only file descriptor (created / truncated), the raw-fd sibling
+// of FileGuard. Writes append at the guard's offset. The descriptor is closed exactly once,
+// after trimming any preallocated space past the bytes actually written.
+class FdGuard
+{
+public:
+    explicit FdGuard(const char *path, const FdOptions &options = {});
+    ~FdGuard();
+
+    FdGuard(const FdGuard &) = delete;
+    FdGuard &operator=(const FdGuard &) = delete;
+
+    FdGuard(FdGuard &&other) noexcept;
+    FdGuard &operator=(FdGuard &&other) noexcept;
+
+    int get() const;
+    explicit operator bool() const;
+    bool direct() const; // O_DIRECT in effect
+
+    // Appends data. Under O_DIRECT, page-aligned runs of whole pages go straight to the
+    // device; anything else (a misaligned source, a short record, the bytes after an odd-sized
+    // write) is collected in an aligned staging block and written as whole pages once the
+    // block fills, so one odd-sized write never knocks later blocks off the direct path.
+    bool write(std::span<const std::byte> data);
+
+    // Writes out whatever is staged, then fdatasync; the data is on stable storage once this
+    // returns true. A staged partial page goes through the page cache but stays staged, so
+    // later writes complete it as a whole page with direct I/O.
+    bool sync();
+
+    static constexpr std::size_t direct_alignment = 4096;
+    static constexpr std::size_t staging_size = 64 * 1024;
+
+private:
+    bool write_at(std::span<const std::byte> data, std::uint64_t offset);
+    bool write_staged();
+    void close();
+    void writeback_hint();
+
+    int fd_ = -1;
+    bool direct_ = false;
+    std::uint64_t offset_ = 0; // under O_DIRECT: bytes written as whole pages, always aligned
+    std::uint64_t preallocated_ = 0;
+    std::optional<AlignedBuffer> staging_; // O_DIRECT only: the bytes after offset_
+    std::size_t staged_ = 0;
+    std::uint64_t sync_every_ = 0;
+    std::uint64_t synced_ = 0; // writeback started up to here
+};
+
+FdGuard::FdGuard(const char *path, const FdOptions &options) : sync_every_(options.sync_every)
+{
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    if (options.direct)
+    {
+        fd_ = ::open(path, flags | O_DIRECT, 0644);
+        direct_ = fd_ >= 0;
+    }
+    if (fd_ < 0)
+        fd_ = ::open(path, flags, 0644);
+    if (fd_ < 0)
+        return;
+
+    if (direct_)
+        staging_.emplace(staging_size, direct_alignment);
+    if (options.preallocate > 0 && ::posix_fallocate(fd_, 0, static_cast<off_t>(options.preallocate)) == 0)
+        preallocated_ = options.preallocate;
+    ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+FdGuard::~FdGuard()
+{
+    close();
+}
+
+FdGuard::FdGuard(FdGuard &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)), direct_(other.direct_), offset_(other.offset_),
+      preallocated_(other.preallocated_), staging_(std::move(other.staging_)),
+      staged_(std::exchange(other.staged_, 0)), sync_every_(other.sync_every_), synced_(other.synced_)
+{
+}
+
+FdGuard &FdGuard::operator=(FdGuard &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        fd_ = std::exchange(other.fd_, -1);
+        direct_ = other.direct_;
+        offset_ = other.offset_;
+        preallocated_ = other.preallocated_;
+        staging_ = std::move(other.staging_);
+        staged_ = std::exchange(other.staged_, 0);
+        sync_every_ = other.sync_every_;
+        synced_ = other.synced_;
+    }
+    return *this;
+}
+
+int FdGuard::get() const
+{
+    return fd_;
+}
+
+FdGuard::operator bool() const
+{
+    return fd_ >= 0;
+}
+
+bool FdGuard::direct() const
+{
+    return direct_;
+}
+
+bool FdGuard::write(std::span<const std::byte> data)
+{
+    if (fd_ < 0)
+        return false;
+
+    if (!direct_)
+    {
+        const bool ok = write_at(data, offset_);
+        if (ok)
+            offset_ += data.size();
+        if (ok && sync_every_ > 0 && offset_ - synced_ >= sync_every_)
+            writeback_hint();
+        return ok;
+    }
+
+    const std::span<std::byte> staging = staging_->span();
+    while (!data.empty())
+    {
+        if (staged_ == 0 && reinterpret_cast<std::uintptr_t>(data.data()) % direct_alignment == 0 &&
+            data.size() >= direct_alignment)
+        {
+            const std::size_t pages = data.size() / direct_alignment * direct_alignment;
+            if (!write_at(data.first(pages), offset_))
+                return false;
+            offset_ += pages;
+            data = data.subspan(pages);
+            continue;
+        }
+
+        const std::size_t n = std::min(data.size(), staging.size() - staged_);
+        std::memcpy(staging.data() + staged_, data.data(), n);
+        staged_ += n;
+        data = data.subspan(n);
+        if (staged_ == staging.size())
+        {
+            if (!write_at(staging, offset_))
+                return false;
+            offset_ += staging.size();
+            staged_ = 0;
+        }
+    }
+    return true;
+}
+
+bool FdGuard::sync()
+{
+    if (fd_ < 0)
+        return false;
+    const bool written = write_staged();
+    return ::fdatasync(fd_) == 0 && written;
+}
+
+bool FdGuard::write_at(std::span<const std::byte> data, std::uint64_t offset)
+{
+    while (!data.empty())
+    {
+        const ssize_t n = ::pwrite(fd_, data.data(), data.size(), static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        offset += static_cast<std::uint64_t>(n);
+        data = data.subspan(static_cast<std::size_t>(n));
+    }
+    return true;
+}
+
+// O_DIRECT: whole staged pages go out directly and leave the staging block; a trailing
+// partial page is written through the page cache (O_DIRECT cleared for that one pwrite) and
+// kept staged, so offset_ stays page-aligned.
+bool FdGuard::write_staged()
+{
+    if (!direct_ || staged_ == 0)
+        return true;
+
+    const std::span<std::byte> staging = staging_->span();
+    const std::size_t pages = staged_ / direct_alignment * direct_alignment;
+    if (pages > 0)
+    {
+        if (!write_at(staging.first(pages), offset_))
+            return false;
+        offset_ += pages;
+        staged_ -= pages;
+        std::memmove(staging.data(), staging.data() + pages, staged_);
+    }
+    if (staged_ == 0)
+        return true;
+
+    const int flags = ::fcntl(fd_, F_GETFL);
+    if (flags < 0 || ::fcntl(fd_, F_SETFL, flags & ~O_DIRECT) < 0)
+        return false;
+    const bool ok = write_at(staging.first(staged_), offset_);
+    return ::fcntl(fd_, F_SETFL, flags) == 0 && ok;
+}
+
+void FdGuard::writeback_hint()
+{
+    // Start writeback of the new window without waiting, then wait for the previous window
+    // (long since submitted) and drop it from the page cache, so dirty and cached pages stay
+    // bounded at about two windows instead of growing with the file.
+    const std::uint64_t start = synced_;
+    const std::uint64_t length = offset_ - synced_;
+    ::sync_file_range(fd_, static_cast<off_t>(start), static_cast<off_t>(length), SYNC_FILE_RANGE_WRITE);
+    if (start >= sync_every_)
+    {
+        const std::uint64_t previous = start - sync_every_;
+        ::sync_file_range(fd_, static_cast<off_t>(previous), static_cast<off_t>(sync_every_),
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        ::posix_fadvise(fd_, static_cast<off_t>(previous), static_cast<off_t>(sync_every_), POSIX_FADV_DONTNEED);
+    }
+    synced_ = offset_;
+}
+
+void FdGuard::close()
+{
+    if (fd_ >= 0)
+    {
+        write_staged();
+        const std::uint64_t size = offset_ + staged_;
+        if (preallocated_ > size)
+            ::ftruncate(fd_, static_cast<off_t>(size));
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+// ---- Asynchronous writer ----
+
+// Backends hand buffers to the kernel (io_uring) or to a worker thread (pwrite) and report
+// back which slots finished. Both are driven from the owning thread only.
+namespace async_io
+{
+struct Request
+{
+    std::uint32_t slot;
+    const std::byte *data;
+    std::uint32_t length;
+    std::uint64_t offset;
+};
+
+struct Completion
+{
+    std::uint32_t slot;
+    std::int32_t result; // bytes written or -errno
+};
+
+class Backend
+{
+public:
+    virtual ~Backend() = default;
+
+    // Queues all requests; one kernel transition (or one wake-up) for the batch.
+    virtual bool submit(std::span<const Request> requests) = 0;
+
+    // Copies finished requests into `out`. With wait == false this never blocks.
+    virtual std::size_t reap(std::span<Completion> out, bool wait) = 0;
+};
+
+// io_uring over raw syscalls (no liburing): the submission and completion rings are shared
+// memory, so a batch costs one io_uring_enter and reaping costs none. The buffer block is
+// registered once so the kernel does not map the pages on every write (WRITE_FIXED); if
+// registration fails (RLIMIT_MEMLOCK) plain WRITE is used.
+class Uring final : public Backend
+{
+public:
+    static std::unique_ptr<Uring> create(int fd, std::span<std::byte> buffers, unsigned entries);
+    ~Uring() override;
+
+    bool submit(std::span<const Request> requests) override;
+    std::size_t reap(std::span<Completion> out, bool wait) override;
+
+private:
+    Uring() = default;
+
+    int ring_ = -1;
+    int fd_ = -1;
+    bool fixed_ = false;
+
+    void *sq_map_ = MAP_FAILED;
+    std::size_t sq_map_size_ = 0;
+    void *cq_map_ = MAP_FAILED;
+    std::size_t cq_map_size_ = 0;
+    io_uring_sqe *sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+    std::size_t sqes_size_ = 0;
+
+    unsigned *sq_tail_ = nullptr;
+    unsigned *sq_mask_ = nullptr;
+    unsigned *sq_array_ = nullptr;
+    unsigned *cq_head_ = nullptr;
+    unsigned *cq_tail_ = nullptr;
+    unsigned *cq_mask_ = nullptr;
+    io_uring_cqe *cqes_ = nullptr;
+};
+
+std::unique_ptr<Uring> Uring::create(int fd, std::span<std::byte> buffers, unsigned entries)
+{
+    io_uring_params params{};
+    const int ring = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (ring < 0)
+        return nullptr;
+
+    std::unique_ptr<Uring> uring(new Uring());
+    uring->ring_ = ring;
+    uring->fd_ = fd;
+
+    uring->sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    uring->cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap)
+        uring->sq_map_size_ = uring->cq_map_size_ = std::max(uring->sq_map_size_, uring->cq_map_size_);
+
+    uring->sq_map_ = ::mmap(nullptr, uring->sq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring,
+                            IORING_OFF_SQ_RING);
+    if (uring->sq_map_ == MAP_FAILED)
+        return nullptr;
+    if (!single_mmap)
+    {
+        uring->cq_map_ = ::mmap(nullptr, uring->cq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring,
+                                IORING_OFF_CQ_RING);
+        if (uring->cq_map_ == MAP_FAILED)
+            return nullptr;
+    }
+    uring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    uring->sqes_ = static_cast<io_uring_sqe *>(::mmap(nullptr, uring->sqes_size_, PROT_READ | PROT_WRITE,
+                                                      MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES));
+    if (uring->sqes_ == MAP_FAILED)
+        return nullptr;
+
+    auto *sq = static_cast<std::byte *>(uring->sq_map_);
+    auto *cq = static_cast<std::byte *>(single_mmap ? uring->sq_map_ : uring->cq_map_);
+    uring->sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    uring->sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    uring->sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    uring->cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    uring->cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    uring->cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    uring->cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    iovec block{buffers.data(), buffers.size()};
+    uring->fixed_ = ::syscall(__NR_io_uring_register, ring, IORING_REGISTER_BUFFERS, &block, 1) == 0;
+    return uring;
+}
+
+Uring::~Uring()
+{
+    // Closing the ring does not wait for requests still in flight (teardown is asynchronous in
+    // the kernel), so the owner must have reaped every one first: AsyncWriter::close drains.
+    if (sqes_ != MAP_FAILED)
+        ::munmap(sqes_, sqes_size_);
+    if (cq_map_ != MAP_FAILED)
+        ::munmap(cq_map_, cq_map_size_);
+    if (sq_map_ != MAP_FAILED)
+        ::munmap(sq_map_, sq_map_size_);
+    if (ring_ >= 0)
+        ::close(ring_);
+}
+
+bool Uring::submit(std::span<const Request> requests)
+{
+    // Only this thread writes the SQ tail; the kernel reads it once the release store lands.
+    unsigned tail = *sq_tail_;
+    const unsigned mask = *sq_mask_;
+    for (const Request &request : requests)
+    {
+        const unsigned index = tail & mask;
+        io_uring_sqe &sqe = sqes_[index];
+        sqe = {};
+        sqe.opcode = fixed_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        // Buffered writes would otherwise be tried inline, copying the whole buffer inside
+        // io_uring_enter; punt them to the kernel's worker pool so submission stays cheap.
+        sqe.flags = IOSQE_ASYNC;
+        sqe.fd = fd_;
+        sqe.addr = reinterpret_cast<std::uint64_t>(request.data);
+        sqe.len = request.length;
+        sqe.off = request.offset;
+        sqe.user_data = request.slot;
+        sqe.buf_index = 0;
+        sq_array_[index] = index;
+        ++tail;
+    }
+    std::atomic_ref<unsigned>(*sq_tail_).store(tail, std::memory_order_release);
+
+    auto pending = static_cast<unsigned>(requests.size());
+    while (pending > 0)
+    {
+        const long consumed = ::syscall(__NR_io_uring_enter, ring_, pending, 0, 0, nullptr, 0);
+        if (consumed < 0 && errno == EINTR)
+            continue;
+        if (consumed <= 0)
+            return false;
+        pending -= static_cast<unsigned>(consumed);
+    }
+    return true;
+}
+
+std::size_t Uring::reap(std::span<Completion> out, bool wait)
+{
+    unsigned head = *cq_head_;
+    unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+    while (wait && head == tail)
+    {
+        ::syscall(__NR_io_uring_enter, ring_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+    }
+
+    std::size_t count = 0;
+    for (; head != tail && count < out.size(); ++head, ++count)
+    {
+        const io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+        out[count] = {static_cast<std::uint32_t>(cqe.user_data), cqe.res};
+    }
+    std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+    return count;
+}
+
+// Worker thread + pwrite. Requests and completions travel through two single-producer /
+// single-consumer rings sized for every slot, so neither side ever waits for room and the
+// owner reaps with one acquire load. The worker sleeps on an atomic counter (futex) between
+// batches.
+class PwriteThread final : public Backend
+{
+public:
+    PwriteThread(int fd, std::uint32_t slots);
+    ~PwriteThread() override;
+
+    bool submit(std::span<const Request> requests) override;
+    std::size_t reap(std::span<Completion> out, bool wait) override;
+
+private:
+    void run();
+
+    int fd_;
+    std::uint32_t mask_;
+    std::vector<Request> requests_;
+    std::vector<Completion> completions_;
+
+    alignas(64) std::atomic<std::uint32_t> request_tail_{0}; // owner writes
+    alignas(64) std::atomic<std::uint32_t> request_head_{0}; // worker writes
+    alignas(64) std::atomic<std::uint32_t> completion_tail_{0}; // worker writes
+    alignas(64) std::atomic<std::uint32_t> completion_head_{0}; // owner writes
+    std::atomic<std::uint64_t> signal_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread worker_;
+};
+
+PwriteThread::PwriteThread(int fd, std::uint32_t slots)
+    : fd_(fd), mask_(std::bit_ceil(slots) - 1), requests_(mask_ + 1), completions_(mask_ + 1),
+      worker_(&PwriteThread::run, this)
+{
+}
+
+PwriteThread::~PwriteThread()
+{
+    // The worker finishes every queued request before it looks at stopping_.
+    stopping_.store(true, std::memory_order_release);
+    signal_.fetch_add(1, std::memory_order_release);
+    signal_.notify_one();
+    worker_.join();
+}
+
+bool PwriteThread::submit(std::span<const Request> requests)
+{
+    std::uint32_t tail = request_tail_.load(std::memory_order_relaxed);
+    for (const Request &request : requests)
+        requests_[tail++ & mask_] = request;
+    request_tail_.store(tail, std::memory_order_release);
+    signal_.fetch_add(1, std::memory_order_release);
+    signal_.notify_one();
+    return true;
+}
+
+std::size_t PwriteThread::reap(std::span<Completion> out, bool wait)
+{
+    std::uint32_t head = completion_head_.load(std::memory_order_relaxed);
+    std::uint32_t tail = completion_tail_.load(std::memory_order_acquire);
+    while (wait && head == tail)
+    {
+        completion_tail_.wait(tail, std::memory_order_acquire);
+        tail = completion_tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t count = 0;
+    for (; head != tail && count < out.size(); ++head, ++count)
+        out[count] = completions_[head & mask_];
+    completion_head_.store(head, std::memory_order_release);
+    return count;
+}
+
+void PwriteThread::run()
+{
+    std::uint64_t seen = 0;
+    for (;;)
+    {
+        std::uint32_t head = request_head_.load(std::memory_order_relaxed);
+        const std::uint32_t tail = request_tail_.load(std::memory_order_acquire);
+        for (; head != tail; ++head)
+        {
+            const Request request = requests_[head & mask_];
+            ssize_t written = ::pwrite(fd_, request.data, request.length, static_cast<off_t>(request.offset));
+            if (written < 0)
+                written = -errno;
+
+            const std::uint32_t slot = completion_tail_.load(std::memory_order_relaxed);
+            completions_[slot & mask_] = {request.slot, static_cast<std::int32_t>(written)};
+            completion_tail_.store(slot + 1, std::memory_order_release);
+            completion_tail_.notify_one();
+        }
+        request_head_.store(head, std::memory_order_release);
+
+        if (request_tail_.load(std::memory_order_acquire) != head)
+            continue;
+        if (stopping_.load(std::memory_order_acquire))
+            return;
+        signal_.wait(seen, std::memory_order_acquire);
+        seen = signal_.load(std::memory_order_acquire);
+    }
+}
+} // namespace async_io
+
+struct AsyncOptions
+{
+    std::size_t buffer_size = std::size_t{1} << 20; // bytes per buffer (rounded up to a page)
+    std::uint32_t buffer_count = 8;                  // buffers in the ring; bounds data in flight
+    bool allow_io_uring = true;                      // false forces the pwrite thread
+};
+
+// Move-only writer whose write() never waits for the disk: records are copied into a ring of
+// page-aligned buffers, each full buffer is handed to io_uring (or a pwrite thread) and its
+// completion is reaped later by polling shared memory. When every buffer is in flight, write()
+// refuses the record instead of stalling the caller.
+//
+// Lifetime follows FileGuard: the destructor (and move assignment) submits the partial buffer,
+// waits for every write still in flight and only then closes the descriptor, exactly once. All
+// state lives in one heap block, so moving the guard never moves a buffer the kernel is using.
+class AsyncWriter
+{
+public:
+    explicit AsyncWriter(const char *path, const AsyncOptions &options = {});
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter &) = delete;
+    AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+    AsyncWriter(AsyncWriter &&other) noexcept;
+    AsyncWriter &operator=(AsyncWriter &&other) noexcept;
+
+    explicit operator bool() const;
+    bool uses_io_uring() const;
+
+    // Copies data into the ring and submits buffers it fills. Returns false, having written
+    // nothing, if the ring has no room for all of it right now.
+    bool write(std::string_view data);
+
+    // Submits the partly filled buffer. Does not wait.
+    bool flush();
+
+    // Recycles buffers whose writes completed. Does not wait; write() calls it when needed.
+    void poll();
+
+    // Submits the partial buffer and blocks until every write completed, even after a
+    // failure, so no buffer is still in the kernel's hands. False if any write failed.
+    bool drain();
+
+    std::uint32_t in_flight() const;
+    bool failed() const;
+
+private:
+    struct Slot
+    {
+        std::uint64_t offset = 0;
+        std::uint32_t length = 0;
+        std::uint32_t done = 0; // bytes already written (short writes are resubmitted)
+    };
+
+    struct State
+    {
+        int fd = -1;
+        AlignedBuffer storage;
+        std::size_t buffer_size;
+        std::vector<Slot> slots;
+        std::vector<std::uint32_t> free; // stack of idle slots
+        std::vector<async_io::Request> batch;
+        std::vector<async_io::Completion> completions;
+        std::unique_ptr<async_io::Backend> backend; // declared last: destroyed before storage
+        bool io_uring = false;
+        bool failed = false;
+        std::uint32_t current = 0; // slot being filled, valid while has_current
+        bool has_current = false;
+        std::size_t used = 0;
+        std::uint64_t offset = 0;
+        std::uint32_t in_flight = 0;
+
+        State(std::size_t size, std::uint32_t count);
+        std::byte *buffer(std::uint32_t slot);
+    };
+
+    void queue_current();
+    bool submit_batch();
+    void reap(bool wait);
+    void close();
+
+    std::unique_ptr<State> state_;
+};
+
+AsyncWriter::State::State(std::size_t size, std::uint32_t count)
+    : storage(size * count), buffer_size(size), slots(count), completions(count)
+{
+    free.reserve(count);
+    for (std::uint32_t slot = count; slot-- > 0;)
+        free.push_back(slot);
+    batch.reserve(count);
+}
+
+std::byte *AsyncWriter::State::buffer(std::uint32_t slot)
+{
+    return storage.span().data() + std::size_t{slot} * buffer_size;
+}
+
+AsyncWriter::AsyncWriter(const char *path, const AsyncOptions &options)
+{
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return;
+
+    const std::size_t size = (std::max<std::size_t>(options.buffer_size, 1) + page_size - 1) / page_size * page_size;
+    const std::uint32_t count = std::max<std::uint32_t>(options.buffer_count, 1);
+    state_ = std::make_unique<State>(size, count);
+    state_->fd = fd;
+    if (options.allow_io_uring)
+    {
+        state_->backend = async_io::Uring::create(fd, state_->storage.span(), std::bit_ceil(count));
+        state_->io_uring = state_->backend != nullptr;
+    }
+    if (!state_->backend)
+        state_->backend = std::make_unique<async_io::PwriteThread>(fd, count);
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    close();
+}
+
+AsyncWriter::AsyncWriter(AsyncWriter &&other) noexcept : state_(std::move(other.state_))
+{
+}
+
+AsyncWriter &AsyncWriter::operator=(AsyncWriter &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+AsyncWriter::operator bool() const
+{
+    return state_ != nullptr;
+}
+
+bool AsyncWriter::uses_io_uring() const
+{
+    return state_ && state_->io_uring;
+}
+
+std::uint32_t AsyncWriter::in_flight() const
+{
+    return state_ ? state_->in_flight : 0;
+}
+
+bool AsyncWriter::failed() const
+{
+    return state_ && state_->failed;
+}
+
+bool AsyncWriter::write(std::string_view data)
+{
+    if (!state_)
+        return false;
+    State &s = *state_;
+
+    auto room = [&]
+    {
+        const std::size_t current = s.has_current ? s.buffer_size - s.used : 0;
+        return current + s.free.size() * s.buffer_size;
+    };
+    if (room() < data.size())
+    {
+        reap(false);
+        if (room() < data.size())
+            return false;
+    }
+
+    while (!data.empty())
+    {
+        if (!s.has_current)
+        {
+            s.current = s.free.back();
+            s.free.pop_back();
+            s.has_current = true;
+            s.used = 0;
+        }
+        const std::size_t n = std::min(data.size(), s.buffer_size - s.used);
+        std::memcpy(s.buffer(s.current) + s.used, data.data(), n);
+        s.used += n;
+        data.remove_prefix(n);
+        if (s.used == s.buffer_size)
+            queue_current();
+    }
+    return submit_batch();
+}
+
+bool AsyncWriter::flush()
+{
+    if (!state_)
+        return false;
+    if (state_->has_current && state_->used > 0)
+        queue_current();
+    return submit_batch();
+}
+
+void AsyncWriter::poll()
+{
+    if (state_)
+        reap(false);
+}
+
+bool AsyncWriter::drain()
+{
+    if (!state_)
+        return false;
+    // A failed flush only means some write failed; the others still own their buffers.
+    flush();
+    while (state_->in_flight > 0)
+        reap(true);
+    return !state_->failed;
+}
+
+void AsyncWriter::queue_current()
+{
+    State &s = *state_;
+    s.slots[s.current] = {s.offset, static_cast<std::uint32_t>(s.used), 0};
+    s.batch.push_back({s.current, s.buffer(s.current), static_cast<std::uint32_t>(s.used), s.offset});
+    s.offset += s.used;
+    s.has_current = false;
+    s.used = 0;
+}
+
+bool AsyncWriter::submit_batch()
+{
+    State &s = *state_;
+    if (s.batch.empty())
+        return !s.failed;
+    if (s.backend->submit(s.batch))
+    {
+        s.in_flight += static_cast<std::uint32_t>(s.batch.size());
+    }
+    else
+    {
+        // Never reached the kernel: the data is lost, the buffers are idle again.
+        s.failed = true;
+        for (const async_io::Request &request : s.batch)
+            s.free.push_back(request.slot);
+    }
+    s.batch.clear();
+    return !s.failed;
+}
+
+void AsyncWriter::reap(bool wait)
+{
+    State &s = *state_;
+    const std::size_t count = s.backend->reap(s.completions, wait);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto [slot, result] = s.completions[i];
+        Slot &pending = s.slots[slot];
+        if (result == -EINTR || result == -EAGAIN)
+        {
+            // Retry the same range.
+        }
+        else if (result <= 0)
+        {
+            s.failed = true;
+            pending.done = pending.length;
+        }
+        else
+        {
+            pending.done += static_cast<std::uint32_t>(result);
+        }
+
+        if (pending.done == pending.length)
+        {
+            s.free.push_back(slot);
+            --s.in_flight;
+        }
+        else
+        {
+            s.batch.push_back({slot, s.buffer(slot) + pending.done, pending.length - pending.done,
+                               pending.offset + pending.done});
+        }
+    }
+    if (!s.batch.empty())
+    {
+        // Resubmissions are already counted as in flight.
+        s.in_flight -= static_cast<std::uint32_t>(s.batch.size());
+        submit_batch();
+    }
+}
+
+void AsyncWriter::close()
+{
+    if (state_)
+    {
+        drain();
+        state_->backend.reset();
+        ::close(state_->fd);
+        state_.reset();
+    }
+}
+
+#endif // __linux__
+
+std::string read_file(const char *path)
+{
+    std::string text;
+    if (std::FILE *f = std::fopen(path, "rb"))
+    {
+        char chunk[4096];
+        std::size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+            text.append(chunk, n);
+        std::fclose(f);
+    }
+    return text;
+}
+
+// records/s writing `total` bytes of `record_size`-byte records ('\n'-terminated).
+void run_benchmarks()
+{
+    constexpr std::size_t total = std::size_t{128} << 20;
+    const std::string path = (std::filesystem::temp_directory_path() / "kata_001_bench.bin").string();
+    AlignedBuffer one_mb(std::size_t{1} << 20);
+    AlignedBuffer four_mb(std::size_t{4} << 20);
+
+    auto records_per_s = [&](std::size_t count, std::size_t record_size, auto &&write_all)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        write_all();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        assert(std::filesystem::file_size(path) == count * record_size);
+        (void)record_size;
+        return static_cast<double>(count) / elapsed.count();
+    };
+
+    std::printf("%7s %16s %16s %16s  (M records/s, %zu MB per run)\n", "record", "fputs", "buffer 1 MB", "buffer 4 MB",
+                total >> 20);
+    for (std::size_t record_size : {16, 64, 256})
+    {
+        std::string record(record_size - 1, 'x');
+        record += '\n';
+        const std::size_t count = total / record_size;
+
+        auto with_fputs = [&]
+        {
+            FileGuard file(path.c_str(), "wb");
+            for (std::size_t i = 0; i < count; ++i)
+                std::fputs(record.c_str(), file.get());
+        };
+        auto with_buffer = [&](const AlignedBuffer &buffer)
+        {
+            return [&]
+            {
+                FileGuard file(path.c_str(), "wb");
+                file.use_buffer(buffer.span());
+                for (std::size_t i = 0; i < count; ++i)
+                    file.write(record);
+            };
+        };
+        const double fputs_rate = records_per_s(count, record_size, with_fputs);
+        const double one_mb_rate = records_per_s(count, record_size, with_buffer(one_mb));
+        const double four_mb_rate = records_per_s(count, record_size, with_buffer(four_mb));
+        std::printf("%5zu B %16.2f %16.2f %16.2f\n", record_size, fputs_rate / 1e6, one_mb_rate / 1e6, four_mb_rate / 1e6);
+    }
+    std::filesystem::remove(path);
+}
+
+#if defined(__linux__)
+
+// Sustained throughput writing `megabytes` MB in 1 MB blocks, until the data is on disk
+// (final fdatasync / fflush + fsync included), plus the latency of each 1 MB write call.
+void bench_sustained_writes(std::uint64_t megabytes)
+{
+    constexpr std::size_t block_size = std::size_t{1} << 20;
+    const std::string path = (std::filesystem::temp_directory_path() / "kata_001_sustained.bin").string();
+    AlignedBuffer block(block_size);
+    auto bytes = block.span();
+    std::memset(bytes.data(), 'x', bytes.size());
+    const std::string line(page_size - 1, 'x');
+
+    std::vector<double> latencies(megabytes);
+    auto run = [&](const char *name, auto &&write_block, auto &&finish)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < megabytes; ++i)
+        {
+            const auto before = std::chrono::steady_clock::now();
+            write_block();
+            latencies[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - before).count();
+        }
+        finish();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) { return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))]; };
+        std::printf("%-26s %10.0f %10.0f %10.0f %10.0f\n", name, static_cast<double>(megabytes) / elapsed.count(),
+                    percentile(0.5), percentile(0.99), latencies.back());
+    };
+
+    std::printf("%-26s %10s %10s %10s %10s  (%llu MB, per-MB write latency in us)\n", "writer", "MB/s", "p50", "p99",
+                "max", static_cast<unsigned long long>(megabytes));
+    {
+        FileGuard file(path.c_str(), "wb");
+        run(
+            "FileGuard + fputs",
+            [&]
+            {
+                for (std::size_t written = 0; written < block_size; written += page_size)
+                {
+                    std::fputs(line.c_str(), file.get());
+                    std::fputc('\n', file.get());
+                }
+            },
+            [&]
+            {
+                std::fflush(file.get());
+                ::fsync(::fileno(file.get()));
+            });
+    }
+    {
+        FdGuard file(path.c_str(), {.sync_every = 8 * block_size});
+        run("FdGuard + sync_file_range", [&] { file.write(bytes); }, [&] { file.sync(); });
+    }
+    {
+        FdGuard file(path.c_str(), {.direct = true, .preallocate = megabytes * block_size});
+        run(file.direct() ? "FdGuard O_DIRECT+fallocate" : "FdGuard (no O_DIRECT here)", [&] { file.write(bytes); },
+            [&] { file.sync(); });
+    }
+    std::filesystem::remove(path);
+}
+
+// A paced loop emitting one 256-byte record per microsecond (256 MB/s) for `megabytes` MB:
+// percentiles of the time each write call takes away from the loop, and records refused
+// because every buffer was still in flight.
+void bench_hot_loop(std::uint64_t megabytes)
+{
+    constexpr std::size_t record_size = 256;
+    constexpr auto interval = std::chrono::microseconds(1);
+    const std::string path = (std::filesystem::temp_directory_path() / "kata_001_hot_loop.bin").string();
+    std::string record(record_size - 1, 'x');
+    record += '\n';
+    const std::size_t count = megabytes * (std::size_t{1} << 20) / record_size;
+
+    std::vector<double> stalls(count);
+    auto run = [&](const char *name, auto &&write_record)
+    {
+        std::size_t refused = 0;
+        auto deadline = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // Stand-in for the loop's own work: wait for the next tick.
+            deadline += interval;
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+            }
+            const auto before = std::chrono::steady_clock::now();
+            refused += !write_record();
+            stalls[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - before).count();
+        }
+
+        std::sort(stalls.begin(), stalls.end());
+        auto percentile = [&](double p) { return stalls[static_cast<std::size_t>(p * (stalls.size() - 1))]; };
+        std::printf("%-20s %9.2f %9.2f %9.2f %9.0f %9zu\n", name, percentile(0.5), percentile(0.99), percentile(0.999),
+                    stalls.back(), refused);
+    };
+
+    std::printf("%-20s %9s %9s %9s %9s %9s  (us per write, %llu MB of %zu-byte records)\n", "writer", "p50", "p99",
+                "p99.9", "max", "refused", static_cast<unsigned long long>(megabytes), record_size);
+    {
+        FileGuard file(path.c_str(), "wb");
+        run("FileGuard + fputs", [&] { return std::fputs(record.c_str(), file.get()) >= 0; });
+    }
+    for (bool io_uring : {true, false})
+    {
+        AsyncWriter writer(path.c_str(), {.allow_io_uring = io_uring});
+        run(writer.uses_io_uring() ? "AsyncWriter io_uring" : "AsyncWriter thread", [&] { return writer.write(record); });
+    }
+    std::filesystem::remove(path);
+}
+
+#endif // __linux__
+
+int main(int argc, char **argv)
 {
     {
         std::cout << "Writing to example.txt\n"
@@ -110,5 +1301,176 @@ int main()
         std::fputs("Second write after close\n", again.get());
     }
 
+    {
+        std::cout << "Buffered writes\n"
+                  << std::endl;
+
+        const std::string path = (std::filesystem::temp_directory_path() / "kata_001_buffered.txt").string();
+        AlignedBuffer buffer(2 * page_size);
+        std::string expected;
+        {
+            FileGuard file(path.c_str(), "wb");
+            assert(!file.use_buffer(buffer.span().subspan(1, page_size)) && "Misaligned buffer must be rejected");
+            assert(file.use_buffer(buffer.span()));
+
+            // Records straddling the buffer end, more than one buffer in one write.
+            for (int i = 0; i < 1000; ++i)
+            {
+                const std::string record = "record " + std::to_string(i) + "\n";
+                assert(file.write(record));
+                expected += record;
+            }
+            const std::string big(3 * page_size + 17, 'b');
+            assert(file.write(big));
+            expected += big;
+
+            // A moved-from guard neither flushes nor closes; the target owns the pending bytes.
+            FileGuard moved = std::move(file);
+            assert(!file && !file.write("lost") && moved);
+            assert(moved.flush());
+            assert(read_file(path.c_str()) == expected);
+            assert(moved.write("tail\n"));
+            expected += "tail\n";
+
+            // Move assignment flushes and closes the target's own file first.
+            FileGuard target(path.c_str(), "ab");
+            target = std::move(moved);
+            assert(target && !moved);
+        }
+        assert(read_file(path.c_str()) == expected && "Destructor flushes the pending tail");
+        std::filesystem::remove(path);
+    }
+
+#if defined(__linux__)
+    {
+        std::cout << "Descriptor writes\n"
+                  << std::endl;
+
+        const std::string path = (std::filesystem::temp_directory_path() / "kata_001_fd.bin").string();
+        const std::string other_path = path + ".other";
+        AlignedBuffer block(4 * page_size);
+        auto bytes = block.span();
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<std::byte>('a' + i % 26);
+        const std::string text(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+
+        for (bool direct : {false, true})
+        {
+            std::string expected;
+            {
+                FdGuard file(path.c_str(), {.direct = direct, .preallocate = std::uint64_t{1} << 20, .sync_every = page_size});
+                assert(file && "Failed to open descriptor");
+                assert(file.write(bytes));
+                expected += text;
+                // An odd-sized block leaves the file unaligned; under O_DIRECT it is staged and
+                // the aligned block after it still goes out as whole pages.
+                assert(file.write(bytes.subspan(0, 100)));
+                expected += text.substr(0, 100);
+                assert(file.write(bytes));
+                expected += text;
+                assert(file.sync());
+                assert(read_file(path.c_str()).starts_with(expected) && "Synced data is in the file");
+                // More than a staging block at once, from a misaligned source.
+                for (int i = 0; i < 20; ++i)
+                {
+                    assert(file.write(bytes.subspan(1)));
+                    expected += text.substr(1);
+                }
+
+                FdGuard moved = std::move(file);
+                assert(!file && !file.write(bytes) && moved);
+                assert(moved.sync());
+                // Move assignment closes the target's own descriptor first.
+                FdGuard target(other_path.c_str());
+                target = std::move(moved);
+                assert(target && !moved);
+            }
+            assert(read_file(path.c_str()) == expected && "Preallocated space is trimmed on close");
+        }
+        std::filesystem::remove(path);
+        std::filesystem::remove(other_path);
+
+        FdGuard missing("/nonexistent-dir/kata_001.bin");
+        assert(!missing && missing.get() == -1 && !missing.write(bytes));
+    }
+
+    {
+        std::cout << "Asynchronous writes\n"
+                  << std::endl;
+
+        const std::string path = (std::filesystem::temp_directory_path() / "kata_001_async.bin").string();
+        const std::string other_path = path + ".other";
+        for (bool io_uring : {true, false})
+        {
+            std::string expected;
+            {
+                AsyncWriter writer(path.c_str(), {.buffer_size = page_size, .buffer_count = 4, .allow_io_uring = io_uring});
+                assert(writer && "Failed to open async writer");
+                assert(writer.uses_io_uring() <= io_uring);
+
+                // Records straddling buffers; the loop drains whenever the ring is full.
+                for (int i = 0; i < 1000; ++i)
+                {
+                    const std::string record = "record " + std::to_string(i) + "\n";
+                    while (!writer.write(record))
+                        assert(writer.drain());
+                    expected += record;
+                }
+                assert(!writer.write(std::string(5 * page_size, 'x')) && "Larger than the ring is refused");
+                assert(writer.drain() && writer.in_flight() == 0);
+                assert(read_file(path.c_str()) == expected);
+
+                const std::string big(2 * page_size + 17, 'b');
+                assert(writer.write(big) && writer.flush());
+                expected += big;
+
+                AsyncWriter moved = std::move(writer);
+                assert(!writer && !writer.write("lost") && moved);
+                assert(moved.write("tail\n"));
+                expected += "tail\n";
+
+                // Move assignment drains and closes the target's own file first.
+                AsyncWriter target(other_path.c_str(), {.allow_io_uring = io_uring});
+                assert(target.write("other\n"));
+                target = std::move(moved);
+                assert(target && !moved && read_file(other_path.c_str()) == "other\n");
+            }
+            assert(read_file(path.c_str()) == expected && "Destructor drains in-flight writes");
+            assert(!AsyncWriter(path.c_str(), {.allow_io_uring = io_uring}).failed());
+        }
+        std::filesystem::remove(path);
+        std::filesystem::remove(other_path);
+
+        // A failing write marks the writer failed, but drain (and so close) still waits for
+        // everything submitted after it before the buffers can be freed.
+        for (bool io_uring : {true, false})
+        {
+            AsyncWriter full("/dev/full", {.buffer_size = page_size, .buffer_count = 4, .allow_io_uring = io_uring});
+            assert(full && "Failed to open /dev/full");
+            const std::string block(page_size, 'x');
+            full.write(block);
+            while (!full.failed())
+                full.poll();
+            assert(!full.write(block) && !full.write(block) && full.in_flight() == 2);
+            assert(!full.drain() && full.in_flight() == 0);
+        }
+
+        AsyncWriter missing("/nonexistent-dir/kata_001.bin");
+        assert(!missing && !missing.write("x") && !missing.flush() && missing.in_flight() == 0);
+    }
+#endif
+
+    std::cout << "All tests passed!\n";
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+#if defined(__linux__)
+        const std::uint64_t megabytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+        bench_sustained_writes(megabytes);
+        bench_hot_loop(megabytes / 4);
+#endif
+    }
+
     return 0;
-}
\ No newline at end of file
+}
@@ -1,21 +1,176 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <climits>
+#include <cstdint>
 #include <cstdio>
 #include <cassert>
 #include <charconv>
 #include <cctype>
+#include <cstring>
+#include <concepts>
 #include <iostream>
+#include <limits>
 #include <optional>
+#include <random>
+#include <span>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC / Clang need a per-function target to emit AVX2 in a baseline x86-64 build; MSVC does not.
+#if defined(__GNUC__) || defined(__clang__)
+#define KATA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define KATA_TARGET_AVX2
+#endif
 
 /*
 std::optional: https://en.cppreference.com/w/cpp/utility/optional
 std::from_chars: https://en.cppreference.com/w/cpp/utility/from_chars
 std::string_view: https://en.cppreference.com/w/cpp/string/basic_string_view
 std::nullopt: https://en.cppreference.com/w/cpp/utility/optional/nullopt
+
+parse_int_strict<T> covers every integer type (except bool) and bases 2..36, accepting
+exactly what a full-length std::from_chars accepts. Validation and conversion share one
+pass: whitespace and '+' simply fail the digit test. Digits that cannot overflow T (a
+per-base table built at compile time) skip the overflow check. It is constexpr, so
+constants can be checked with static_assert. parse_int_strict_two_pass is the original
+isspace + from_chars version, kept as the reference and benchmark baseline.
+
+Batch mode: parse_int_strict_batch splits a buffer on `delim` and gives, per field,
+exactly what parse_int_strict returns. A field is valid iff it is an optional '-'
+followed by one or more digits that fit in int (whitespace, '+' and anything else
+are rejected, as with from_chars). Delimiters and non-digits are found 64 bytes at a
+time with SSE2 / AVX2 compare masks, and digits are converted eight at a time with
+SWAR multiplies.
+
+Run with --bench for GB/s against a field-by-field parse_int_strict loop, and ns per call
+by field length (1..20 chars) for the two-pass and single-pass parsers.
 */
 
-std::optional<int> parse_int_strict(std::string_view str);
+template <class T>
+concept parse_integral = std::integral<T> && !std::same_as<std::remove_cv_t<T>, bool>;
+
+// Strict parse of the whole of str as a T in base 2..36: an optional '-' (signed T only)
+// followed by one or more digits, nothing else. Same acceptance as a full-length
+// std::from_chars, checked and converted in a single pass; constexpr-evaluable.
+template <parse_integral T = int>
+constexpr std::optional<T> parse_int_strict(std::string_view str, int base = 10);
+
+// The original two-pass parser (isspace scan, then from_chars), kept as the reference.
+template <parse_integral T = int>
+std::optional<T> parse_int_strict_two_pass(std::string_view str, int base = 10);
+
+namespace detail
+{
+    // 0..35 for [0-9a-zA-Z], 255 otherwise.
+    constexpr unsigned digit_value(char ch)
+    {
+        const auto c = static_cast<unsigned char>(ch);
+        if (const unsigned d = c - static_cast<unsigned>('0'); d < 10)
+        {
+            return d;
+        }
+        if (const unsigned d = (c | 0x20u) - static_cast<unsigned>('a'); d < 26)
+        {
+            return d + 10;
+        }
+        return 255;
+    }
+
+    // Per base, how many digits always fit in T (base^n <= max), so they need no overflow check.
+    template <class T>
+    constexpr auto safe_digits = []
+    {
+        using U = std::make_unsigned_t<T>;
+        constexpr U max = static_cast<U>(std::numeric_limits<T>::max());
+        std::array<std::uint8_t, 37> table{};
+        for (unsigned base = 2; base <= 36; ++base)
+        {
+            U power = 1;
+            while (power <= max / base)
+            {
+                power = static_cast<U>(power * base);
+                ++table[base];
+            }
+        }
+        return table;
+    }();
+} // namespace detail
+
+template <parse_integral T>
+constexpr std::optional<T> parse_int_strict(std::string_view str, int base)
+{
+    using U = std::make_unsigned_t<T>;
+    if (base < 2 || base > 36)
+    {
+        return std::nullopt;
+    }
+    const auto ubase = static_cast<unsigned>(base);
+
+    const char *p = str.data();
+    const char *const last = p + str.size();
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (p != last && *p == '-')
+        {
+            negative = true;
+            ++p;
+        }
+    }
+    if (p == last)
+    {
+        return std::nullopt;
+    }
+
+    // Whitespace, '+' and every other non-digit fail the digit test, so there is no separate scan.
+    U acc = 0;
+    const auto len = static_cast<std::size_t>(last - p);
+    const char *const safe_end = p + std::min<std::size_t>(len, detail::safe_digits<T>[ubase]);
+    for (; p != safe_end; ++p)
+    {
+        const unsigned d = detail::digit_value(*p);
+        if (d >= ubase)
+        {
+            return std::nullopt;
+        }
+        acc = static_cast<U>(acc * ubase + d);
+    }
 
-std::optional<int> parse_int_strict(std::string_view str)
+    if (p != last)
+    {
+        // Long field: check each remaining digit against the magnitude limit.
+        const U limit = static_cast<U>(static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1u : 0u));
+        const U cutoff = static_cast<U>(limit / ubase);
+        const unsigned cutlim = static_cast<unsigned>(limit % ubase);
+        for (; p != last; ++p)
+        {
+            const unsigned d = detail::digit_value(*p);
+            if (d >= ubase || acc > cutoff || (acc == cutoff && d > cutlim))
+            {
+                return std::nullopt;
+            }
+            acc = static_cast<U>(acc * ubase + d);
+        }
+    }
+
+    // Two's-complement wrap gives the negative value, including T's minimum.
+    return static_cast<T>(negative ? static_cast<U>(U{0} - acc) : acc);
+}
+
+template <parse_integral T>
+std::optional<T> parse_int_strict_two_pass(std::string_view str, int base)
 {
     // Reject empty input.
     if (str.empty())
@@ -32,11 +187,11 @@ std::optional<int> parse_int_strict(std::string_view str)
         }
     }
 
-    int value{};
+    T value{};
     const char *first = str.data();
     const char *last = first + str.size();
 
-    const auto [ptr, ec] = std::from_chars(first, last, value, 10);
+    const auto [ptr, ec] = std::from_chars(first, last, value, base);
     if (ec != std::errc{})
     {
         // Includes invalid input and overflow/underflow (std::errc::result_out_of_range).
@@ -53,7 +208,418 @@ std::optional<int> parse_int_strict(std::string_view str)
     return value;
 }
 
-int main()
+// Config constants can be checked at compile time.
+static_assert(parse_int_strict<std::uint16_t>("8080") == 8080);
+static_assert(!parse_int_strict<std::uint16_t>("65536"));
+static_assert(parse_int_strict<std::int64_t>("-9223372036854775808") == INT64_MIN);
+static_assert(parse_int_strict<std::uint32_t>("ff", 16) == 255u);
+static_assert(!parse_int_strict<unsigned>("-1"));
+
+struct BatchResult
+{
+    std::size_t fields;   // entries written to out / ok
+    std::size_t consumed; // bytes of buffer covered by those fields (including delimiters)
+};
+
+// Parses every `delim`-separated field of buffer into out / ok (1 = parsed, 0 = rejected, out = 0).
+// A trailing delimiter does not start an extra field. Stops early when out or ok is full;
+// resume with buffer.substr(result.consumed).
+BatchResult parse_int_strict_batch(std::string_view buffer, char delim, std::span<int> out, std::span<std::uint8_t> ok);
+
+// Per-64-byte classification: bit i set when byte i is the delimiter / is not a digit.
+struct ByteMasks
+{
+    std::uint64_t delim;
+    std::uint64_t non_digit;
+};
+
+ByteMasks classify_scalar(const char *p, char delim)
+{
+    ByteMasks m{0, 0};
+    for (int i = 0; i < 64; ++i)
+    {
+        const auto c = static_cast<unsigned char>(p[i]);
+        m.delim |= std::uint64_t{c == static_cast<unsigned char>(delim)} << i;
+        m.non_digit |= std::uint64_t{static_cast<unsigned>(c - '0') > 9u} << i;
+    }
+    return m;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+// SSE2 is part of the x86-64 baseline. Signed compares are enough: '0'..'9' are
+// positive and bytes >= 0x80 are negative, so they fall outside the digit range.
+ByteMasks classify_sse2(const char *p, char delim)
+{
+    const __m128i d = _mm_set1_epi8(delim);
+    const __m128i lo = _mm_set1_epi8('0' - 1);
+    const __m128i hi = _mm_set1_epi8('9' + 1);
+    ByteMasks m{0, 0};
+    for (int i = 0; i < 4; ++i)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * i));
+        const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmplt_epi8(v, hi));
+        const auto dm = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, d)));
+        const auto nm = static_cast<std::uint16_t>(~_mm_movemask_epi8(digit));
+        m.delim |= std::uint64_t{dm} << (16 * i);
+        m.non_digit |= std::uint64_t{nm} << (16 * i);
+    }
+    return m;
+}
+
+KATA_TARGET_AVX2 ByteMasks classify_avx2(const char *p, char delim)
+{
+    const __m256i d = _mm256_set1_epi8(delim);
+    const __m256i lo = _mm256_set1_epi8('0' - 1);
+    const __m256i hi = _mm256_set1_epi8('9' + 1);
+    ByteMasks m{0, 0};
+    for (int i = 0; i < 2; ++i)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * i));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+        const auto dm = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, d)));
+        const auto nm = static_cast<std::uint32_t>(~_mm256_movemask_epi8(digit));
+        m.delim |= std::uint64_t{dm} << (32 * i);
+        m.non_digit |= std::uint64_t{nm} << (32 * i);
+    }
+    return m;
+}
+
+bool cpu_has_avx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false; // OS does not save YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+using ClassifyFn = ByteMasks (*)(const char *, char);
+
+ClassifyFn best_classifier()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    static const ClassifyFn fn = cpu_has_avx2() ? classify_avx2 : classify_sse2;
+    return fn;
+#else
+    return classify_scalar;
+#endif
+}
+
+// Eight digit values (0..9, one per byte, most significant at the lowest address)
+// combined with three multiply / shift steps.
+std::uint32_t swar_combine(std::uint64_t v)
+{
+    v = (v & 0x0F0F0F0F0F0F0F0F) * 2561 >> 8;
+    v = (v & 0x00FF00FF00FF00FF) * 6553601 >> 16;
+    v = (v & 0x0000FFFF0000FFFF) * 42949672960001 >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+
+std::uint64_t load_le64(const char *p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        v = std::byteswap(v);
+    }
+    return v;
+}
+
+// 1..8 digits ending at p + len. When at least 8 bytes of the buffer precede the end, load
+// the 8 bytes ending there and zero the bytes before p (leading zero digits); otherwise copy
+// into a '0'-padded word.
+std::uint32_t swar_up_to_8_digits(const char *buffer_begin, const char *p, std::size_t len)
+{
+    if (p + len - buffer_begin >= 8)
+    {
+        // No '0' subtraction: swar_combine keeps the low nibble, and zeroed bytes read as 0.
+        return swar_combine(load_le64(p + len - 8) & (~std::uint64_t{0} << (8 * (8 - len))));
+    }
+    char padded[8] = {'0', '0', '0', '0', '0', '0', '0', '0'};
+    std::memcpy(padded + 8 - len, p, len);
+    return swar_combine(load_le64(padded));
+}
+
+// Digits only (already validated). Same range rules as from_chars into int.
+std::optional<int> convert_digits(const char *buffer_begin, const char *p, std::size_t len, bool negative)
+{
+    while (len > 0 && *p == '0')
+    {
+        ++p;
+        --len;
+    }
+    if (len > 10)
+    {
+        return std::nullopt;
+    }
+
+    std::uint64_t magnitude = 0;
+    if (len <= 8)
+    {
+        magnitude = len == 0 ? 0 : swar_up_to_8_digits(buffer_begin, p, len);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < len - 8; ++i)
+        {
+            magnitude = magnitude * 10 + static_cast<std::uint64_t>(p[i] - '0');
+        }
+        magnitude = magnitude * 100'000'000 + swar_combine(load_le64(p + len - 8));
+    }
+
+    const std::uint64_t limit = negative ? std::uint64_t{INT_MAX} + 1 : std::uint64_t{INT_MAX};
+    if (magnitude > limit)
+    {
+        return std::nullopt;
+    }
+    return negative ? static_cast<int>(-static_cast<std::int64_t>(magnitude)) : static_cast<int>(magnitude);
+}
+
+BatchResult parse_int_strict_batch(std::string_view buffer, char delim, std::span<int> out, std::span<std::uint8_t> ok)
+{
+    const std::size_t capacity = std::min(out.size(), ok.size());
+    const ClassifyFn classify = best_classifier();
+    const char *data = buffer.data();
+    const std::size_t size = buffer.size();
+
+    std::size_t fields = 0;
+    std::size_t field_start = 0;
+    std::size_t bad_count = 0;        // non-digits seen in the current field
+    std::size_t first_bad = SIZE_MAX; // position of the first one
+
+    auto finish_field = [&](std::size_t end)
+    {
+        const char *p = data + field_start;
+        const std::size_t len = end - field_start;
+        std::optional<int> value;
+        if (bad_count == 0 && len > 0)
+        {
+            value = convert_digits(data, p, len, false);
+        }
+        else if (bad_count == 1 && first_bad == field_start && *p == '-' && len > 1)
+        {
+            value = convert_digits(data, p + 1, len - 1, true);
+        }
+        out[fields] = value.value_or(0);
+        ok[fields] = value.has_value();
+        ++fields;
+
+        field_start = end + 1;
+        bad_count = 0;
+        first_bad = SIZE_MAX;
+    };
+
+    auto accumulate = [&](std::uint64_t bad, std::size_t base)
+    {
+        if (bad != 0)
+        {
+            if (bad_count == 0)
+            {
+                first_bad = base + static_cast<std::size_t>(std::countr_zero(bad));
+            }
+            bad_count += static_cast<std::size_t>(std::popcount(bad));
+        }
+    };
+
+    for (std::size_t base = 0; base < size && fields < capacity; base += 64)
+    {
+        ByteMasks m{};
+        if (size - base >= 64)
+        {
+            m = classify(data + base, delim);
+        }
+        else
+        {
+            // Tail: classify a padded copy and drop the bits past the end.
+            char tail[64] = {};
+            std::memcpy(tail, data + base, size - base);
+            m = classify(tail, delim);
+            const std::uint64_t valid = (std::uint64_t{1} << (size - base)) - 1;
+            m.delim &= valid;
+            m.non_digit &= valid;
+        }
+
+        // Delimiters are not part of any field.
+        std::uint64_t non_digit = m.non_digit & ~m.delim;
+        std::uint64_t delims = m.delim;
+        while (delims != 0 && fields < capacity)
+        {
+            const auto d = static_cast<std::size_t>(std::countr_zero(delims));
+            const std::uint64_t before = d == 0 ? 0 : (~std::uint64_t{0} >> (64 - d));
+            accumulate(non_digit & before, base);
+            non_digit &= ~before;
+            finish_field(base + d);
+            delims &= delims - 1;
+        }
+        if (fields == capacity)
+        {
+            break;
+        }
+        accumulate(non_digit, base);
+    }
+
+    if (field_start < size && fields < capacity)
+    {
+        finish_field(size);
+    }
+    return {fields, std::min(field_start, size)};
+}
+
+// Field-by-field baseline: find the delimiter, call the scalar parser.
+std::size_t parse_fields_scalar(std::string_view buffer, char delim, std::span<int> out, std::span<std::uint8_t> ok)
+{
+    std::size_t fields = 0;
+    while (!buffer.empty() && fields < out.size())
+    {
+        const std::size_t end = std::min(buffer.find(delim), buffer.size());
+        const auto value = parse_int_strict(buffer.substr(0, end));
+        out[fields] = value.value_or(0);
+        ok[fields] = value.has_value();
+        ++fields;
+        buffer.remove_prefix(std::min(end + 1, buffer.size()));
+    }
+    return fields;
+}
+
+// ns per call on fields of 1..20 digits (half negative): the int versions overflow past 10 digits.
+void bench_field_lengths()
+{
+    constexpr std::size_t count = 1 << 14;
+    constexpr int reps = 32;
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> digit('0', '9');
+
+    auto ns_per_call = [&](const std::vector<std::string> &fields, auto &&parse)
+    {
+        long long sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+        {
+            for (const std::string &f : fields)
+            {
+                sink += static_cast<long long>(parse(f).value_or(0));
+            }
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        volatile long long keep = sink;
+        (void)keep;
+        return elapsed.count() / (count * reps);
+    };
+
+    std::printf("%5s %14s %14s %16s\n", "len", "two_pass<int>", "strict<int>", "strict<int64_t>");
+    for (std::size_t len = 1; len <= 20; ++len)
+    {
+        std::vector<std::string> fields(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string &f = fields[i];
+            if (i % 2 == 1 && len > 1)
+            {
+                f += '-';
+            }
+            while (f.size() < len)
+            {
+                f += static_cast<char>(digit(rng));
+            }
+        }
+        const double two_pass = ns_per_call(fields, [](std::string_view f) { return parse_int_strict_two_pass<int>(f); });
+        const double strict = ns_per_call(fields, [](std::string_view f) { return parse_int_strict<int>(f); });
+        const double strict64 = ns_per_call(fields, [](std::string_view f) { return parse_int_strict<std::int64_t>(f); });
+        std::printf("%5zu %14.2f %14.2f %16.2f\n", len, two_pass, strict, strict64);
+    }
+}
+
+void run_benchmarks()
+{
+    // ~64 MB of newline-delimited ints, 1 in 100 fields malformed.
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> value(INT_MIN, INT_MAX);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::string buffer;
+    buffer.reserve(std::size_t{70} << 20);
+    while (buffer.size() < (std::size_t{64} << 20))
+    {
+        buffer += std::to_string(value(rng) >> (percent(rng) % 28));
+        if (percent(rng) == 0)
+        {
+            buffer += ' ';
+        }
+        buffer += '\n';
+    }
+
+    const std::size_t max_fields = buffer.size() / 2 + 1;
+    std::vector<int> out(max_fields);
+    std::vector<std::uint8_t> ok(max_fields);
+
+    auto gb_per_s = [&](auto &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t fields = fn();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return std::pair{static_cast<double>(buffer.size()) / elapsed.count() / 1e9, fields};
+    };
+
+    const auto [scalar, scalar_fields] = gb_per_s([&] { return parse_fields_scalar(buffer, '\n', out, ok); });
+    const auto [batch, batch_fields] = gb_per_s([&] { return parse_int_strict_batch(buffer, '\n', out, ok).fields; });
+    assert(scalar_fields == batch_fields);
+
+    std::cout << "Parsing " << buffer.size() / (1 << 20) << " MB, " << batch_fields << " fields\n";
+    std::cout << "  parse_int_strict loop : " << scalar << " GB/s\n";
+    std::cout << "  parse_int_strict_batch: " << batch << " GB/s\n";
+
+    bench_field_lengths();
+}
+
+// Checks every field of buffer against the scalar parser.
+void check_batch_matches_scalar(std::string_view buffer, char delim)
+{
+    std::vector<int> out(buffer.size() + 1);
+    std::vector<std::uint8_t> ok(buffer.size() + 1);
+    const BatchResult r = parse_int_strict_batch(buffer, delim, out, ok);
+    assert(r.consumed == buffer.size());
+
+    std::size_t field = 0;
+    std::string_view rest = buffer;
+    while (!rest.empty())
+    {
+        const std::size_t end = std::min(rest.find(delim), rest.size());
+        const auto expected = parse_int_strict(rest.substr(0, end));
+        assert(field < r.fields);
+        assert(ok[field] == expected.has_value());
+        assert(out[field] == expected.value_or(0));
+        ++field;
+        rest.remove_prefix(std::min(end + 1, rest.size()));
+    }
+    assert(field == r.fields);
+}
+
+// Checks parse_int_strict<T> against the two-pass from_chars parser on one input.
+template <class T>
+void check_matches_two_pass(std::string_view str, int base)
+{
+    assert(parse_int_strict<T>(str, base) == parse_int_strict_two_pass<T>(str, base));
+}
+
+template <class... Ts>
+void check_all_types(std::string_view str, int base)
+{
+    (check_matches_two_pass<Ts>(str, base), ...);
+}
+
+int main(int argc, char **argv)
 {
 
     // test assertions
@@ -88,7 +654,90 @@ int main()
     // underflow
     assert(parse_int_strict("-2147483649") == std::nullopt);
 
+    // Every integer width and base agrees with from_chars, including the limits of each type.
+    {
+        auto check = [](std::string_view str, int base)
+        {
+            check_all_types<signed char, unsigned char, char, short, unsigned short, int, unsigned, long, unsigned long,
+                            long long, unsigned long long>(str, base);
+        };
+        const std::string_view cases[] = {"", "0", "-0", "-", "+1", " 1", "1 ", "127", "128", "-128", "-129", "255", "256",
+                                          "32767", "-32768", "65535", "65536", "2147483647", "-2147483648", "4294967295",
+                                          "4294967296", "9223372036854775807", "-9223372036854775808", "9223372036854775808",
+                                          "18446744073709551615", "18446744073709551616", "000000000000000000000000255",
+                                          "ff", "FF", "7f", "-80", "zz", "Zz", "1g", "0x10", "101", "12", "9"};
+        for (std::string_view c : cases)
+        {
+            for (int base : {2, 8, 10, 16, 36})
+            {
+                check(c, base);
+            }
+        }
+        assert(!parse_int_strict<int>("1", 1) && !parse_int_strict<int>("1", 37));
+
+        std::mt19937 rng(11);
+        const char alphabet[] = "0123456789abcdefzAFZ--+ ";
+        std::uniform_int_distribution<std::size_t> pick(0, sizeof(alphabet) - 2);
+        std::uniform_int_distribution<int> length(0, 24);
+        std::uniform_int_distribution<int> base(2, 36);
+        std::string str;
+        for (int i = 0; i < 20'000; ++i)
+        {
+            str.clear();
+            const int len = length(rng);
+            for (int k = 0; k < len; ++k)
+            {
+                str += alphabet[pick(rng)];
+            }
+            check(str, base(rng));
+        }
+    }
+
+    // Batch parser matches parse_int_strict on every field, including the cases above.
+    {
+        const std::string_view cases[] = {"", "123", "-7", " 1", "1 ", "1 2", "12x", "+", "2147483648", "-2147483649",
+                                          "2147483647", "-2147483648", "-0", "0000000000000000000042", "-00000000002147483648",
+                                          "+5", "-", "--1", "1-", "99999999999", "12345678", "123456789", "\t7", "7\r"};
+        std::string joined;
+        for (std::string_view c : cases)
+        {
+            joined += c;
+            joined += '\n';
+        }
+        check_batch_matches_scalar(joined, '\n');
+
+        // Random fields over a small alphabet, fields straddling the 64-byte blocks.
+        std::mt19937 rng(10);
+        const char alphabet[] = "0123456789000-+ \tx";
+        std::uniform_int_distribution<std::size_t> pick(0, sizeof(alphabet) - 2);
+        std::uniform_int_distribution<int> length(0, 14);
+        std::string fuzz;
+        for (int i = 0; i < 20'000; ++i)
+        {
+            const int len = length(rng);
+            for (int k = 0; k < len; ++k)
+            {
+                fuzz += alphabet[pick(rng)];
+            }
+            fuzz += ',';
+        }
+        check_batch_matches_scalar(fuzz, ',');
+        fuzz.pop_back(); // no trailing delimiter: last field still parsed
+        check_batch_matches_scalar(fuzz, ',');
+
+        // Output smaller than the field count: stop and report where to resume.
+        int out[2] = {};
+        std::uint8_t ok[2] = {};
+        const BatchResult r = parse_int_strict_batch("1\n22\n333\n", '\n', out, ok);
+        assert(r.fields == 2 && r.consumed == 5 && out[0] == 1 && out[1] == 22 && ok[0] && ok[1]);
+    }
+
     std::cout << "All tests passed!\n";
 
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+    }
+
     return 0;
 }
\ No newline at end of file
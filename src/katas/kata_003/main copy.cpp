@@ -1,9 +1,27 @@
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
 /*
 Exactly one producer thread and one consumer thread
 
@@ -16,81 +34,546 @@ Capacity is fixed at construction
 One slot must remain unused to distinguish full vs empty
 
 No dynamic resizing
+
+Bulk transfer: push_bulk / pop_bulk move as many elements as fit in at most
+two contiguous copies (one before the wrap point, one after).
+
+Each side keeps a cached copy of the other side's index and only reloads the
+shared atomic when the cached value says full / empty.
+
+Fixed capacity: SpScRingBuffer<T, N> with N a power of two stores N elements in
+a std::array, uses free-running 64-bit counters and masks instead of modulo.
+No slot is wasted and there is no heap allocation.
+
+Any T, including move-only and non-trivial types. Slots are raw aligned bytes;
+an element only exists between construction (push / try_claim) and destruction
+(pop / release / ring teardown).
+
+Zero-copy: try_claim() constructs an element in its slot and returns it, the
+producer fills it, commit() publishes it. front() exposes the oldest element in
+place, release() destroys it and frees the slot.
+
+Blocking: push_wait / pop_wait block while full / empty. The third template
+parameter picks how: SpinWait (pause loop), SpinYieldWait (bounded spin, then
+yield) or AtomicWait (std::atomic::wait, futex-backed on Linux). AtomicWait
+only calls notify_one when the other side has actually parked.
+
+MpscQueue<T, N> / MpmcQueue<T, N>: bounded lock-free queues for several
+producers (and consumers) with the same push / pop / size / capacity interface.
+
+Run with --bench to compare per-item and bulk throughput, modulo vs mask,
+copy vs in-place transfer of 256-byte frames, wait strategy wake-up latency,
+and MPSC / MPMC contention.
 */
 
+// Spin-loop hint: lets the sibling hyperthread run and saves power while polling.
+inline void cpu_relax()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Wait strategies: wait() returns once `watched` no longer holds `observed`;
+// notify() runs after every store to `watched` by the other side.
+
+// Pure spin with a pause instruction. Lowest latency, burns a core.
+struct SpinWait
+{
+    template <class I>
+    void wait(const std::atomic<I> &watched, I observed)
+    {
+        while (watched.load(std::memory_order_acquire) == observed)
+        {
+            cpu_relax();
+        }
+    }
+
+    template <class I>
+    void notify(std::atomic<I> &)
+    {
+    }
+};
+
+// Bounded spin, then hand the core back to the scheduler.
+struct SpinYieldWait
+{
+    static constexpr int spin_limit = 256;
+
+    template <class I>
+    void wait(const std::atomic<I> &watched, I observed)
+    {
+        for (int i = 0; i < spin_limit; ++i)
+        {
+            if (watched.load(std::memory_order_acquire) != observed)
+            {
+                return;
+            }
+            cpu_relax();
+        }
+        while (watched.load(std::memory_order_acquire) == observed)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    template <class I>
+    void notify(std::atomic<I> &)
+    {
+    }
+};
+
+// Short spin, then park in std::atomic::wait.
+// Waiter: parked = true, re-check, sleep. Notifier: publish, check parked, wake.
+// The seq_cst fence / store pair guarantees one of them sees the other, so no wake-up is lost,
+// and notify_one (a syscall) only runs when someone is actually asleep.
+struct AtomicWait
+{
+    static constexpr int spin_limit = 256;
+
+    template <class I>
+    void wait(const std::atomic<I> &watched, I observed)
+    {
+        for (int i = 0; i < spin_limit; ++i)
+        {
+            if (watched.load(std::memory_order_acquire) != observed)
+            {
+                return;
+            }
+            cpu_relax();
+        }
+
+        parked_.store(true, std::memory_order_seq_cst);
+        if (watched.load(std::memory_order_seq_cst) == observed)
+        {
+            watched.wait(observed, std::memory_order_acquire);
+        }
+        parked_.store(false, std::memory_order_relaxed);
+    }
+
+    template <class I>
+    void notify(std::atomic<I> &watched)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed))
+        {
+            watched.notify_one();
+        }
+    }
+
+    // Written by the waiter only when parking; read by the notifier on every publish.
+    alignas(64) std::atomic<bool> parked_{false};
+};
+
+// Selects the runtime-capacity (modulo, heap-backed) ring.
+inline constexpr std::size_t dynamic_capacity = 0;
+
+template <class T, std::size_t N = dynamic_capacity, class Wait = SpinWait>
 class SpScRingBuffer
 {
+    static constexpr bool fixed = N != dynamic_capacity;
+    static_assert(!fixed || std::has_single_bit(N), "Fixed capacity must be a power of two");
+
 public:
-    explicit SpScRingBuffer(std::size_t capacity);
-    ~SpScRingBuffer() = default;
+    SpScRingBuffer() requires fixed = default;
+    explicit SpScRingBuffer(std::size_t capacity) requires(!fixed);
+    ~SpScRingBuffer();
 
     SpScRingBuffer(const SpScRingBuffer &) = delete;
     SpScRingBuffer &operator=(const SpScRingBuffer &) = delete;
 
-    bool push(int value); // false if full
-    bool pop(int &value); // false if empty
+    bool push(const T &value); // false if full
+    bool push(T &&value);      // false if full
+    template <class... Args>
+    bool emplace(Args &&...args); // false if full
+    bool pop(T &value);           // false if empty
+
+    // Block (per Wait) until there is room / an element.
+    void push_wait(const T &value);
+    void push_wait(T &&value);
+    template <class... Args>
+    void emplace_wait(Args &&...args);
+    void pop_wait(T &value);
+
+    std::size_t push_bulk(std::span<const T> values); // number pushed, may be short
+    std::size_t pop_bulk(std::span<T> values);        // number popped, may be short
+
+    // Producer: construct in place, fill, then publish. nullptr if full.
+    template <class... Args>
+    T *try_claim(Args &&...args);
+    void commit();
+
+    // Consumer: oldest element in place, then destroy it. nullptr if empty.
+    T *front();
+    void release();
 
     std::size_t size() const;
     std::size_t capacity() const;
 
 private:
-    // Backing storage size is (logical_capacity + 1) so one slot is always unused.
-    std::size_t storage_capacity_ = 0;
-    std::vector<int> buffer_;
+    // Raw storage for one element; sizeof(Slot) == sizeof(T), so slots are contiguous Ts.
+    struct Slot
+    {
+        alignas(T) std::byte bytes[sizeof(T)];
+    };
+
+    // Dynamic: wrapped indices in [0, storage_capacity_). Fixed: free-running counters.
+    using index_type = std::conditional_t<fixed, std::uint64_t, std::size_t>;
+    using storage_type = std::conditional_t<fixed, std::array<Slot, N>, std::unique_ptr<Slot[]>>;
+
+    T *element(std::size_t slot);
+    bool producer_full(index_type head);
+    bool consumer_empty(index_type tail);
+
+    std::size_t slot(index_type index) const;
+    index_type advance(index_type index, std::size_t count) const;
+    bool full(index_type head, index_type tail) const;
+    std::size_t used_slots(index_type head, index_type tail) const;
+    std::size_t storage_size() const;
+
+    // Dynamic only: backing storage size is (capacity + 1) so one slot is always unused.
+    std::size_t storage_capacity_ = N;
+    storage_type buffer_{};
+
+    // Single producer writes head_, single consumer writes tail_.
+    // Each cache line also holds the owning side's private copy of the remote index.
+    alignas(64) std::atomic<index_type> head_{0};
+    index_type tail_cache_ = 0; // producer-only
+    bool claimed_ = false;      // producer-only: slot at head_ is constructed but unpublished
 
-    // Indices into [0, storage_capacity_). Single producer writes head_, single consumer writes tail_.
-    alignas(64) std::atomic<std::size_t> head_{0};
-    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<index_type> tail_{0};
+    index_type head_cache_ = 0; // consumer-only
+
+    // Consumer waits on head_ via not_empty_, producer waits on tail_ via not_full_.
+    [[no_unique_address]] Wait not_empty_;
+    [[no_unique_address]] Wait not_full_;
 };
 
-SpScRingBuffer::SpScRingBuffer(std::size_t capacity)
+template <class T, std::size_t N, class Wait>
+SpScRingBuffer<T, N, Wait>::SpScRingBuffer(std::size_t capacity)
+    requires(!fixed)
+{
+    // One extra slot distinguishes full vs empty, so capacity() == capacity.
+    // capacity == 0 gives a single unused slot: push always fails, no division by zero.
+    storage_capacity_ = capacity + 1;
+    buffer_ = std::make_unique_for_overwrite<Slot[]>(storage_capacity_);
+}
+
+template <class T, std::size_t N, class Wait>
+SpScRingBuffer<T, N, Wait>::~SpScRingBuffer()
 {
-    // One slot remains unused to distinguish full vs empty.
-    // If capacity == 0, this becomes a valid zero-capacity ring (push always fails).
-    storage_capacity_ = capacity;
-    buffer_.resize(storage_capacity_);
+    // Unconsumed (and claimed but uncommitted) elements are still alive.
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        const index_type head = head_.load(std::memory_order_acquire);
+        for (index_type i = tail_.load(std::memory_order_acquire); i != head; i = advance(i, 1))
+        {
+            std::destroy_at(element(slot(i)));
+        }
+        if (claimed_)
+        {
+            std::destroy_at(element(slot(head)));
+        }
+    }
+}
 
-    head_.store(0, std::memory_order_relaxed);
-    tail_.store(0, std::memory_order_relaxed);
+template <class T, std::size_t N, class Wait>
+bool SpScRingBuffer<T, N, Wait>::push(const T &value)
+{
+    return emplace(value);
 }
 
-bool SpScRingBuffer::push(int value)
+template <class T, std::size_t N, class Wait>
+bool SpScRingBuffer<T, N, Wait>::push(T &&value)
 {
-    const std::size_t head = head_.load(std::memory_order_relaxed);
-    const std::size_t next = (head + 1) % storage_capacity_;
+    return emplace(std::move(value));
+}
 
-    // Full when next head would collide with current tail.
-    const std::size_t tail = tail_.load(std::memory_order_acquire);
-    if (next == tail)
+template <class T, std::size_t N, class Wait>
+template <class... Args>
+bool SpScRingBuffer<T, N, Wait>::emplace(Args &&...args)
+{
+    assert(!claimed_ && "Commit the claimed slot before pushing");
+    const index_type head = head_.load(std::memory_order_relaxed);
+    if (producer_full(head))
     {
         return false;
     }
 
-    buffer_[head] = value;
-    head_.store(next, std::memory_order_release);
+    std::construct_at(element(slot(head)), std::forward<Args>(args)...);
+    head_.store(advance(head, 1), std::memory_order_release);
+    not_empty_.notify(head_);
     return true;
 }
 
-bool SpScRingBuffer::pop(int &value)
+template <class T, std::size_t N, class Wait>
+void SpScRingBuffer<T, N, Wait>::push_wait(const T &value)
+{
+    emplace_wait(value);
+}
+
+template <class T, std::size_t N, class Wait>
+void SpScRingBuffer<T, N, Wait>::push_wait(T &&value)
 {
-    const std::size_t tail = tail_.load(std::memory_order_relaxed);
-    const std::size_t head = head_.load(std::memory_order_acquire);
+    emplace_wait(std::move(value));
+}
 
-    if (tail == head)
+template <class T, std::size_t N, class Wait>
+template <class... Args>
+void SpScRingBuffer<T, N, Wait>::emplace_wait(Args &&...args)
+{
+    // emplace() only consumes args on success, so retrying is safe.
+    while (!emplace(std::forward<Args>(args)...))
+    {
+        // Full: tail_cache_ is the tail we saw; wait for the consumer to move it.
+        not_full_.wait(tail_, tail_cache_);
+    }
+}
+
+template <class T, std::size_t N, class Wait>
+void SpScRingBuffer<T, N, Wait>::pop_wait(T &value)
+{
+    while (!pop(value))
+    {
+        // Empty: head_cache_ is the head we saw; wait for the producer to move it.
+        not_empty_.wait(head_, head_cache_);
+    }
+}
+
+template <class T, std::size_t N, class Wait>
+bool SpScRingBuffer<T, N, Wait>::pop(T &value)
+{
+    T *item = front();
+    if (!item)
     {
         return false;
     }
 
-    value = buffer_[tail];
-    const std::size_t next = (tail + 1) % storage_capacity_;
-    tail_.store(next, std::memory_order_release);
+    value = std::move(*item);
+    release();
     return true;
 }
 
-std::size_t SpScRingBuffer::size() const
+template <class T, std::size_t N, class Wait>
+std::size_t SpScRingBuffer<T, N, Wait>::push_bulk(std::span<const T> values)
+{
+    assert(!claimed_ && "Commit the claimed slot before pushing");
+    const index_type head = head_.load(std::memory_order_relaxed);
+
+    std::size_t free = capacity() - used_slots(head, tail_cache_);
+    if (free < values.size())
+    {
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        free = capacity() - used_slots(head, tail_cache_);
+    }
+
+    const std::size_t count = std::min(free, values.size());
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // At most two segments: [slot(head), end) then [0, rest).
+    const std::size_t start = slot(head);
+    const std::size_t first = std::min(count, storage_size() - start);
+    std::uninitialized_copy_n(values.data(), first, element(start));
+    std::uninitialized_copy_n(values.data() + first, count - first, element(0));
+
+    head_.store(advance(head, count), std::memory_order_release);
+    not_empty_.notify(head_);
+    return count;
+}
+
+template <class T, std::size_t N, class Wait>
+std::size_t SpScRingBuffer<T, N, Wait>::pop_bulk(std::span<T> values)
+{
+    const index_type tail = tail_.load(std::memory_order_relaxed);
+
+    std::size_t available = used_slots(head_cache_, tail);
+    if (available < values.size())
+    {
+        head_cache_ = head_.load(std::memory_order_acquire);
+        available = used_slots(head_cache_, tail);
+    }
+
+    const std::size_t count = std::min(available, values.size());
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    const std::size_t start = slot(tail);
+    const std::size_t first = std::min(count, storage_size() - start);
+    std::move(element(start), element(start) + first, values.data());
+    std::move(element(0), element(0) + (count - first), values.data() + first);
+    std::destroy_n(element(start), first);
+    std::destroy_n(element(0), count - first);
+
+    tail_.store(advance(tail, count), std::memory_order_release);
+    not_full_.notify(tail_);
+    return count;
+}
+
+template <class T, std::size_t N, class Wait>
+template <class... Args>
+T *SpScRingBuffer<T, N, Wait>::try_claim(Args &&...args)
+{
+    assert(!claimed_ && "Commit the claimed slot before claiming another");
+    const index_type head = head_.load(std::memory_order_relaxed);
+    if (producer_full(head))
+    {
+        return nullptr;
+    }
+
+    // Default-initialize when no arguments are given: no zeroing of trivial frames.
+    T *item = element(slot(head));
+    if constexpr (sizeof...(Args) == 0)
+    {
+        item = ::new (static_cast<void *>(item)) T;
+    }
+    else
+    {
+        item = std::construct_at(item, std::forward<Args>(args)...);
+    }
+    claimed_ = true;
+    return item;
+}
+
+template <class T, std::size_t N, class Wait>
+void SpScRingBuffer<T, N, Wait>::commit()
+{
+    assert(claimed_ && "commit() requires a successful try_claim()");
+    claimed_ = false;
+    const index_type head = head_.load(std::memory_order_relaxed);
+    head_.store(advance(head, 1), std::memory_order_release);
+    not_empty_.notify(head_);
+}
+
+template <class T, std::size_t N, class Wait>
+T *SpScRingBuffer<T, N, Wait>::front()
+{
+    const index_type tail = tail_.load(std::memory_order_relaxed);
+    if (consumer_empty(tail))
+    {
+        return nullptr;
+    }
+    return element(slot(tail));
+}
+
+template <class T, std::size_t N, class Wait>
+void SpScRingBuffer<T, N, Wait>::release()
+{
+    const index_type tail = tail_.load(std::memory_order_relaxed);
+    assert(tail != head_cache_ && "release() requires a non-null front()");
+
+    std::destroy_at(element(slot(tail)));
+    tail_.store(advance(tail, 1), std::memory_order_release);
+    not_full_.notify(tail_);
+}
+
+template <class T, std::size_t N, class Wait>
+std::size_t SpScRingBuffer<T, N, Wait>::size() const
+{
+    const index_type head = head_.load(std::memory_order_acquire);
+    const index_type tail = tail_.load(std::memory_order_acquire);
+    return used_slots(head, tail);
+}
+
+template <class T, std::size_t N, class Wait>
+std::size_t SpScRingBuffer<T, N, Wait>::capacity() const
+{
+    if constexpr (fixed)
+    {
+        return N;
+    }
+    // One slot is unused.
+    return storage_capacity_ - 1;
+}
+
+template <class T, std::size_t N, class Wait>
+T *SpScRingBuffer<T, N, Wait>::element(std::size_t slot)
+{
+    Slot *slots = nullptr;
+    if constexpr (fixed)
+    {
+        slots = buffer_.data();
+    }
+    else
+    {
+        slots = buffer_.get();
+    }
+    return std::launder(reinterpret_cast<T *>(slots[slot].bytes));
+}
+
+template <class T, std::size_t N, class Wait>
+bool SpScRingBuffer<T, N, Wait>::producer_full(index_type head)
+{
+    // Only reload tail_ when the cached value says the ring is full.
+    if (full(head, tail_cache_))
+    {
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        return full(head, tail_cache_);
+    }
+    return false;
+}
+
+template <class T, std::size_t N, class Wait>
+bool SpScRingBuffer<T, N, Wait>::consumer_empty(index_type tail)
+{
+    // Empty when tail caught up with head; only reload head_ when the cache says so.
+    if (tail == head_cache_)
+    {
+        head_cache_ = head_.load(std::memory_order_acquire);
+        return tail == head_cache_;
+    }
+    return false;
+}
+
+template <class T, std::size_t N, class Wait>
+std::size_t SpScRingBuffer<T, N, Wait>::slot(index_type index) const
+{
+    if constexpr (fixed)
+    {
+        return static_cast<std::size_t>(index & (N - 1));
+    }
+    return index;
+}
+
+template <class T, std::size_t N, class Wait>
+auto SpScRingBuffer<T, N, Wait>::advance(index_type index, std::size_t count) const -> index_type
+{
+    if constexpr (fixed)
+    {
+        return index + count;
+    }
+    return (index + count) % storage_capacity_;
+}
+
+template <class T, std::size_t N, class Wait>
+bool SpScRingBuffer<T, N, Wait>::full(index_type head, index_type tail) const
 {
-    const std::size_t head = head_.load(std::memory_order_acquire);
-    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    if constexpr (fixed)
+    {
+        return head - tail == N;
+    }
+    // Full when next head would collide with tail.
+    return (head + 1) % storage_capacity_ == tail;
+}
+
+template <class T, std::size_t N, class Wait>
+std::size_t SpScRingBuffer<T, N, Wait>::used_slots(index_type head, index_type tail) const
+{
+    if constexpr (fixed)
+    {
+        // Unsigned subtraction of free-running counters is correct across wrap.
+        return static_cast<std::size_t>(head - tail);
+    }
     if (head >= tail)
     {
         return head - tail;
@@ -98,17 +581,641 @@ std::size_t SpScRingBuffer::size() const
     return (storage_capacity_ - tail) + head;
 }
 
-std::size_t SpScRingBuffer::capacity() const
+template <class T, std::size_t N, class Wait>
+std::size_t SpScRingBuffer<T, N, Wait>::storage_size() const
 {
-    // One slot is unused.
-    return storage_capacity_ - 1;
+    return fixed ? N : storage_capacity_;
 }
 
-int main()
+// Bounded multi-producer queue with a per-cell sequence number (Vyukov).
+// A cell at position pos is free for the producer when sequence == pos, and
+// holds a value for the consumer when sequence == pos + 1. Releasing a cell
+// sets sequence = pos + N, which is the position of its next lap.
+// Producers claim positions with a CAS; with MultiConsumer == false the single
+// consumer owns dequeue_pos_ and skips the CAS.
+template <class T, std::size_t N, bool MultiConsumer>
+class BoundedQueue
 {
+    static_assert(std::has_single_bit(N), "Capacity must be a power of two");
+
+public:
+    BoundedQueue();
+    ~BoundedQueue();
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
 
-    SpScRingBuffer ring_buffer(8);
-    for (int i = 1; i <= 7; ++i)
+    bool push(const T &value); // false if full
+    bool push(T &&value);      // false if full
+    template <class... Args>
+    bool emplace(Args &&...args); // false if full
+    bool pop(T &value);           // false if empty
+
+    std::size_t size() const; // approximate while producers / consumers run
+    std::size_t capacity() const;
+
+private:
+    struct Cell
+    {
+        std::atomic<std::uint64_t> sequence;
+        alignas(T) std::byte bytes[sizeof(T)];
+    };
+
+    T *element(Cell &cell);
+
+    std::array<Cell, N> cells_;
+
+    alignas(64) std::atomic<std::uint64_t> enqueue_pos_{0};
+    alignas(64) std::atomic<std::uint64_t> dequeue_pos_{0};
+};
+
+template <class T, std::size_t N>
+using MpscQueue = BoundedQueue<T, N, false>;
+
+template <class T, std::size_t N>
+using MpmcQueue = BoundedQueue<T, N, true>;
+
+template <class T, std::size_t N, bool MultiConsumer>
+BoundedQueue<T, N, MultiConsumer>::BoundedQueue()
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+BoundedQueue<T, N, MultiConsumer>::~BoundedQueue()
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        const std::uint64_t end = enqueue_pos_.load(std::memory_order_acquire);
+        for (std::uint64_t pos = dequeue_pos_.load(std::memory_order_acquire); pos != end; ++pos)
+        {
+            Cell &cell = cells_[pos & (N - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) == pos + 1)
+            {
+                std::destroy_at(element(cell));
+            }
+        }
+    }
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+bool BoundedQueue<T, N, MultiConsumer>::push(const T &value)
+{
+    return emplace(value);
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+bool BoundedQueue<T, N, MultiConsumer>::push(T &&value)
+{
+    return emplace(std::move(value));
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+template <class... Args>
+bool BoundedQueue<T, N, MultiConsumer>::emplace(Args &&...args)
+{
+    std::uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    for (;;)
+    {
+        cell = &cells_[pos & (N - 1)];
+        const std::uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(sequence - pos);
+        if (diff == 0)
+        {
+            // Cell is free on this lap; race other producers for the position.
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Cell still holds last lap's value: full.
+            return false;
+        }
+        else
+        {
+            // Another producer took this position; catch up.
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    std::construct_at(element(*cell), std::forward<Args>(args)...);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+bool BoundedQueue<T, N, MultiConsumer>::pop(T &value)
+{
+    std::uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell *cell = nullptr;
+    for (;;)
+    {
+        cell = &cells_[pos & (N - 1)];
+        const std::uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(sequence - (pos + 1));
+        if (diff < 0)
+        {
+            // Producer has not published this position yet: empty.
+            return false;
+        }
+        if constexpr (!MultiConsumer)
+        {
+            // Single consumer owns dequeue_pos_, nobody else can take pos.
+            dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+            break;
+        }
+        else if (diff == 0)
+        {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else
+        {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    T *item = element(*cell);
+    value = std::move(*item);
+    std::destroy_at(item);
+    cell->sequence.store(pos + N, std::memory_order_release);
+    return true;
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+std::size_t BoundedQueue<T, N, MultiConsumer>::size() const
+{
+    // Read dequeue first: enqueue_pos_ never falls behind a dequeue_pos_ observed earlier.
+    const std::uint64_t tail = dequeue_pos_.load(std::memory_order_acquire);
+    const std::uint64_t head = enqueue_pos_.load(std::memory_order_acquire);
+    return static_cast<std::size_t>(std::min<std::uint64_t>(head - tail, N));
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+std::size_t BoundedQueue<T, N, MultiConsumer>::capacity() const
+{
+    return N;
+}
+
+template <class T, std::size_t N, bool MultiConsumer>
+T *BoundedQueue<T, N, MultiConsumer>::element(Cell &cell)
+{
+    return std::launder(reinterpret_cast<T *>(cell.bytes));
+}
+
+// Moves `items` ints from a producer thread to a consumer thread and returns Mitems/s.
+// batch == 0 uses push/pop, otherwise push_bulk/pop_bulk with that batch size.
+template <class Ring>
+double transfer_throughput(Ring &ring, std::size_t items, std::size_t batch)
+{
+    long long checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&]
+    {
+        if (batch == 0)
+        {
+            for (std::size_t i = 0; i < items; ++i)
+            {
+                while (!ring.push(static_cast<int>(i)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+            return;
+        }
+
+        std::vector<int> chunk(batch);
+        std::size_t next = 0;
+        while (next < items)
+        {
+            const std::size_t n = std::min(batch, items - next);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                chunk[i] = static_cast<int>(next + i);
+            }
+            std::span<const int> pending(chunk.data(), n);
+            while (!pending.empty())
+            {
+                const std::size_t pushed = ring.push_bulk(pending);
+                if (pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+                pending = pending.subspan(pushed);
+            }
+            next += n;
+        }
+    });
+
+    if (batch == 0)
+    {
+        for (std::size_t i = 0; i < items; ++i)
+        {
+            int out = 0;
+            while (!ring.pop(out))
+            {
+                std::this_thread::yield();
+            }
+            checksum += out;
+        }
+    }
+    else
+    {
+        std::vector<int> chunk(batch);
+        std::size_t received = 0;
+        while (received < items)
+        {
+            const std::size_t popped = ring.pop_bulk(chunk);
+            if (popped == 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < popped; ++i)
+            {
+                checksum += chunk[i];
+            }
+            received += popped;
+        }
+    }
+
+    producer.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const long long n = static_cast<long long>(items);
+    assert(checksum == n * (n - 1) / 2 && "Every item must arrive exactly once");
+    (void)n;
+
+    return static_cast<double>(items) / elapsed.count() / 1e6;
+}
+
+// Single-threaded push + pop pairs; isolates index math from cross-core traffic.
+template <class Ring>
+double push_pop_ns(Ring &ring, std::size_t ops)
+{
+    long long checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ops; ++i)
+    {
+        int out = 0;
+        ring.push(static_cast<int>(i));
+        ring.pop(out);
+        checksum += out;
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    const long long n = static_cast<long long>(ops);
+    assert(checksum == n * (n - 1) / 2);
+    (void)n;
+
+    return elapsed.count() / static_cast<double>(ops);
+}
+
+// Telemetry-sized payload used by the copy vs in-place benchmark.
+struct Frame
+{
+    std::uint64_t sequence;
+    std::byte payload[248];
+};
+
+// Moves `frames` Frames producer -> consumer and returns Mframes/s.
+// in_place == false builds each frame locally and copies it through push/pop;
+// in_place == true writes and reads it in the ring's storage via try_claim/commit and front/release.
+template <class Ring>
+double frame_throughput(Ring &ring, std::size_t frames, bool in_place)
+{
+    std::uint64_t checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&]
+    {
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            if (in_place)
+            {
+                Frame *frame = nullptr;
+                while (!(frame = ring.try_claim()))
+                {
+                    std::this_thread::yield();
+                }
+                frame->sequence = i;
+                std::memset(frame->payload, static_cast<int>(i & 0xff), sizeof(frame->payload));
+                ring.commit();
+            }
+            else
+            {
+                Frame frame;
+                frame.sequence = i;
+                std::memset(frame.payload, static_cast<int>(i & 0xff), sizeof(frame.payload));
+                while (!ring.push(frame))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+
+    for (std::size_t i = 0; i < frames; ++i)
+    {
+        if (in_place)
+        {
+            const Frame *frame = nullptr;
+            while (!(frame = ring.front()))
+            {
+                std::this_thread::yield();
+            }
+            checksum += frame->sequence + static_cast<std::uint64_t>(frame->payload[247]);
+            ring.release();
+        }
+        else
+        {
+            Frame frame;
+            while (!ring.pop(frame))
+            {
+                std::this_thread::yield();
+            }
+            checksum += frame.sequence + static_cast<std::uint64_t>(frame.payload[247]);
+        }
+    }
+
+    producer.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    assert(checksum >= frames * (frames - 1) / 2 && "Every frame must arrive");
+    (void)checksum;
+
+    return static_cast<double>(frames) / elapsed.count() / 1e6;
+}
+
+struct ContentionResult
+{
+    double mitems_per_s;
+    double p99_enqueue_ns;
+};
+
+// `producers` threads push `items` ints in total into `queue` while `consumers` threads drain it.
+// Every 16th push is timed (including retries while full) for the enqueue latency percentile.
+template <class Queue>
+ContentionResult contention_run(Queue &queue, unsigned producers, unsigned consumers, std::size_t items)
+{
+    const std::size_t per_producer = items / producers;
+    const std::size_t total = per_producer * producers;
+
+    std::atomic<unsigned> producers_left{producers};
+    std::atomic<long long> checksum{0};
+    std::vector<std::vector<std::uint32_t>> samples(producers);
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p]
+        {
+            samples[p].reserve(per_producer / 16 + 1);
+            for (std::size_t i = 0; i < per_producer; ++i)
+            {
+                const int value = static_cast<int>(p * per_producer + i);
+                const bool timed = i % 16 == 0;
+                const auto t0 = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+                while (!queue.push(value))
+                {
+                    std::this_thread::yield();
+                }
+                if (timed)
+                {
+                    const auto dt = std::chrono::steady_clock::now() - t0;
+                    samples[p].push_back(static_cast<std::uint32_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()));
+                }
+            }
+
+            // Last producer out sends one stop marker per consumer.
+            if (producers_left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                for (unsigned c = 0; c < consumers; ++c)
+                {
+                    while (!queue.push(-1))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+
+    for (unsigned c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&]
+        {
+            long long sum = 0;
+            for (;;)
+            {
+                int value = 0;
+                if (!queue.pop(value))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                if (value < 0)
+                {
+                    break;
+                }
+                sum += value;
+            }
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const long long n = static_cast<long long>(total);
+    assert(checksum.load() == n * (n - 1) / 2 && "Every item must arrive exactly once");
+    (void)n;
+
+    std::vector<std::uint32_t> all;
+    for (const auto &s : samples)
+    {
+        all.insert(all.end(), s.begin(), s.end());
+    }
+    const std::size_t p99 = all.size() * 99 / 100;
+    std::nth_element(all.begin(), all.begin() + p99, all.end());
+
+    return {static_cast<double>(total) / elapsed.count() / 1e6, static_cast<double>(all[p99])};
+}
+
+template <class Queue>
+void print_contention(const char *name, unsigned producers, unsigned consumers, std::size_t items)
+{
+    auto queue = std::make_unique<Queue>();
+    const ContentionResult r = contention_run(*queue, producers, consumers, items);
+    std::cout << "  " << name << " " << producers << "P/" << consumers << "C : "
+              << r.mitems_per_s << " Mitems/s, p99 enqueue " << r.p99_enqueue_ns << " ns\n";
+}
+
+void run_contention_benchmarks()
+{
+    constexpr std::size_t items = 2'000'000;
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+
+    std::cout << "Contention sweep, " << items << " ints, capacity 4096\n";
+    print_contention<SpScRingBuffer<int, 4096>>("spsc", 1, 1, items);
+    for (unsigned producers = 1; producers <= max_threads; producers *= 2)
+    {
+        print_contention<MpscQueue<int, 4096>>("mpsc", producers, 1, items);
+    }
+    for (unsigned producers = 1; producers <= max_threads; producers *= 2)
+    {
+        for (unsigned consumers = 1; consumers <= max_threads; consumers *= 2)
+        {
+            print_contention<MpmcQueue<int, 4096>>("mpmc", producers, consumers, items);
+        }
+    }
+}
+
+// Producer pushes a steady_clock timestamp every ~50 us; consumer blocks in pop_wait
+// and records how long after the push it woke up. Also reports process CPU time / wall time.
+template <class Wait>
+void wake_latency(const char *name, std::size_t samples)
+{
+    using clock = std::chrono::steady_clock;
+    SpScRingBuffer<std::int64_t, 1024, Wait> ring;
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(samples);
+
+    const auto wall_start = clock::now();
+    const std::clock_t cpu_start = std::clock();
+
+    std::thread producer([&]
+    {
+        for (std::size_t i = 0; i < samples; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            ring.push_wait(clock::now().time_since_epoch().count());
+        }
+    });
+
+    for (std::size_t i = 0; i < samples; ++i)
+    {
+        std::int64_t stamp = 0;
+        ring.pop_wait(stamp);
+        latencies.push_back(clock::now().time_since_epoch().count() - stamp);
+    }
+    producer.join();
+
+    const std::chrono::duration<double> wall = clock::now() - wall_start;
+    const double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p)
+    {
+        const auto ticks = latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::duration(ticks)).count();
+    };
+
+    std::cout << "  " << name << " : p50 " << percentile(0.50) << " ns, p99 " << percentile(0.99)
+              << " ns, p99.9 " << percentile(0.999) << " ns, CPU " << 100.0 * cpu / wall.count() << "%\n";
+}
+
+void run_benchmarks()
+{
+    constexpr std::size_t items = 10'000'000;
+
+    {
+        SpScRingBuffer<int> ring(4096);
+        std::cout << "SPSC transfer of " << items << " ints (modulo, capacity 4096)\n";
+        std::cout << "  per-item push/pop : " << transfer_throughput(ring, items, 0) << " Mitems/s\n";
+        for (std::size_t batch : {16, 64, 256, 1024})
+        {
+            std::cout << "  bulk, batch " << batch << " : " << transfer_throughput(ring, items, batch) << " Mitems/s\n";
+        }
+    }
+    {
+        auto ring = std::make_unique<SpScRingBuffer<int, 4096>>();
+        std::cout << "SPSC transfer of " << items << " ints (mask, capacity 4096)\n";
+        std::cout << "  per-item push/pop : " << transfer_throughput(*ring, items, 0) << " Mitems/s\n";
+        std::cout << "  bulk, batch 256 : " << transfer_throughput(*ring, items, 256) << " Mitems/s\n";
+    }
+    {
+        SpScRingBuffer<int> modulo(1024);
+        auto mask = std::make_unique<SpScRingBuffer<int, 1024>>();
+        std::cout << "Single-thread push+pop, capacity 1024\n";
+        std::cout << "  modulo : " << push_pop_ns(modulo, items) << " ns/op\n";
+        std::cout << "  mask   : " << push_pop_ns(*mask, items) << " ns/op\n";
+    }
+    {
+        constexpr std::size_t frames = 2'000'000;
+        auto ring = std::make_unique<SpScRingBuffer<Frame, 1024>>();
+        std::cout << "SPSC transfer of " << frames << " 256-byte frames (capacity 1024)\n";
+        std::cout << "  copy push/pop           : " << frame_throughput(*ring, frames, false) << " Mframes/s\n";
+        std::cout << "  in-place claim/release  : " << frame_throughput(*ring, frames, true) << " Mframes/s\n";
+    }
+    {
+        constexpr std::size_t samples = 10'000;
+        std::cout << "Wake-up latency, " << samples << " pushes ~50 us apart\n";
+        wake_latency<SpinWait>("spin      ", samples);
+        wake_latency<SpinYieldWait>("spin+yield", samples);
+        wake_latency<AtomicWait>("atomic    ", samples);
+    }
+    run_contention_benchmarks();
+}
+
+// Pushes 0..count-1 through a 4-slot ring with blocking calls on both sides, so
+// producer and consumer each block many times; checks FIFO order.
+template <class Wait>
+void blocking_round_trip(int count)
+{
+    SpScRingBuffer<int, 4, Wait> ring;
+    std::thread producer([&]
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            ring.push_wait(i);
+        }
+    });
+    for (int i = 0; i < count; ++i)
+    {
+        int out = -1;
+        ring.pop_wait(out);
+        assert(out == i && "Blocking pop preserves FIFO order");
+    }
+    producer.join();
+}
+
+// Counts live instances so ring teardown can be checked for leaks and double destruction.
+struct Tracked
+{
+    static inline int live = 0;
+
+    explicit Tracked(int v) : value(v) { ++live; }
+    Tracked(const Tracked &other) : value(other.value) { ++live; }
+    Tracked &operator=(const Tracked &) = default;
+    ~Tracked() { --live; }
+
+    int value;
+};
+
+int main(int argc, char **argv)
+{
+
+    SpScRingBuffer<int> ring_buffer(8);
+    assert(ring_buffer.capacity() == 8);
+    for (int i = 1; i <= 8; ++i)
     {
         assert(ring_buffer.push(i) && "Push should succeed");
     }
@@ -116,7 +1223,7 @@ int main()
     int dummy = 0;
     assert(!ring_buffer.push(999) && "Push should fail when full");
 
-    for (size_t i = 1; i <= 7; i++)
+    for (int i = 1; i <= 8; i++)
     {
         int out = 0;
         assert(ring_buffer.pop(out) && "Pop should succeed");
@@ -125,5 +1232,173 @@ int main()
 
     assert(!ring_buffer.pop(dummy) && "Pop should fail when empty");
 
+    // Bulk transfer across the wrap point (head and tail both sit at index 8 of 9 here).
+    {
+        const int in[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        assert(ring_buffer.push_bulk(in) == 8 && "Bulk push stops at capacity");
+        assert(ring_buffer.size() == 8);
+        assert(ring_buffer.push_bulk(in) == 0 && "Bulk push fails when full");
+
+        int out[9] = {};
+        assert(ring_buffer.pop_bulk(std::span<int>(out, 3)) == 3);
+        assert(out[0] == 1 && out[1] == 2 && out[2] == 3);
+        assert(ring_buffer.pop_bulk(out) == 5 && "Bulk pop stops at size");
+        assert(out[0] == 4 && out[4] == 8);
+        assert(ring_buffer.pop_bulk(out) == 0 && "Bulk pop fails when empty");
+    }
+
+    // Zero capacity is valid: every push fails.
+    {
+        SpScRingBuffer<int> empty(0);
+        assert(empty.capacity() == 0);
+        assert(!empty.push(1) && "Push should fail on zero capacity");
+        assert(!empty.pop(dummy) && "Pop should fail on zero capacity");
+    }
+
+    // Fixed power-of-two capacity: all N slots usable, masking across wrap.
+    {
+        SpScRingBuffer<int, 8> fixed;
+        assert(fixed.capacity() == 8);
+        for (int round = 0; round < 3; ++round)
+        {
+            for (int i = 1; i <= 8; ++i)
+            {
+                assert(fixed.push(i) && "Push should succeed");
+            }
+            assert(!fixed.push(999) && "Push should fail when full");
+            assert(fixed.size() == 8);
+
+            int out[5] = {};
+            assert(fixed.pop_bulk(out) == 5);
+            assert(out[0] == 1 && out[4] == 5);
+            for (int i = 6; i <= 8; ++i)
+            {
+                int value = 0;
+                assert(fixed.pop(value) && value == i);
+            }
+            assert(!fixed.pop(dummy) && "Pop should fail when empty");
+        }
+    }
+
+    // Move-only element type.
+    {
+        SpScRingBuffer<std::unique_ptr<int>> owners(2);
+        assert(owners.push(std::make_unique<int>(1)));
+        assert(owners.emplace(new int(2)));
+        assert(!owners.push(std::make_unique<int>(3)) && "Push should fail when full");
+
+        std::unique_ptr<int> out;
+        assert(owners.pop(out) && *out == 1);
+        assert(owners.pop(out) && *out == 2);
+        assert(!owners.pop(out) && "Pop should fail when empty");
+    }
+
+    // Non-trivial element type: unconsumed and claimed-but-uncommitted elements die with the ring.
+    {
+        {
+            SpScRingBuffer<Tracked, 4> tracked;
+            assert(tracked.emplace(1));
+            assert(tracked.emplace(2));
+            assert(tracked.push(Tracked(3)));
+            assert(Tracked::live == 3);
+
+            Tracked out(0);
+            assert(tracked.pop(out) && out.value == 1);
+            assert(Tracked::live == 3 && "Popped slot destroyed, out still alive");
+
+            Tracked *claimed = tracked.try_claim(4);
+            assert(claimed && claimed->value == 4);
+            assert(Tracked::live == 4);
+        }
+        assert(Tracked::live == 0 && "Teardown destroys every remaining element exactly once");
+    }
+
+    // Zero-copy claim / commit and front / release across the wrap point.
+    {
+        SpScRingBuffer<Frame, 4> frames;
+        assert(frames.front() == nullptr && "front() is null when empty");
+        for (std::uint64_t i = 0; i < 10; ++i)
+        {
+            Frame *slot = frames.try_claim();
+            assert(slot && "Claim should succeed");
+            slot->sequence = i;
+            slot->payload[0] = std::byte{0x5a};
+            assert(frames.size() == 0 && "Claimed frame is not visible before commit");
+            frames.commit();
+
+            const Frame *head = frames.front();
+            assert(head == slot && "Consumer sees the same storage the producer wrote");
+            assert(head->sequence == i && head->payload[0] == std::byte{0x5a});
+            frames.release();
+            assert(frames.front() == nullptr);
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+            assert(frames.try_claim());
+            frames.commit();
+        }
+        assert(frames.try_claim() == nullptr && "Claim should fail when full");
+    }
+
+    // Blocking push_wait / pop_wait for every wait strategy.
+    {
+        SpScRingBuffer<int, 4, AtomicWait> ready;
+        ready.push_wait(7);
+        int out = 0;
+        ready.pop_wait(out);
+        assert(out == 7 && "pop_wait returns immediately when non-empty");
+
+        if (std::thread::hardware_concurrency() > 1)
+        {
+            // Pure spin on a single core only progresses when the spinner is preempted.
+            blocking_round_trip<SpinWait>(2'000);
+        }
+        blocking_round_trip<SpinYieldWait>(2'000);
+        blocking_round_trip<AtomicWait>(2'000);
+    }
+
+    // MPSC / MPMC: same interface, FIFO when used from one thread, all N slots usable.
+    {
+        MpscQueue<int, 4> mpsc;
+        MpmcQueue<int, 4> mpmc;
+        for (int round = 0; round < 3; ++round)
+        {
+            for (int i = 1; i <= 4; ++i)
+            {
+                assert(mpsc.push(i) && mpmc.push(i) && "Push should succeed");
+            }
+            assert(!mpsc.push(999) && !mpmc.push(999) && "Push should fail when full");
+            assert(mpsc.size() == 4 && mpmc.size() == 4 && mpmc.capacity() == 4);
+            for (int i = 1; i <= 4; ++i)
+            {
+                int a = 0;
+                int b = 0;
+                assert(mpsc.pop(a) && mpmc.pop(b) && a == i && b == i);
+            }
+            assert(!mpsc.pop(dummy) && !mpmc.pop(dummy) && "Pop should fail when empty");
+        }
+
+        {
+            MpmcQueue<Tracked, 4> tracked;
+            assert(tracked.emplace(1) && tracked.emplace(2));
+            Tracked out(0);
+            assert(tracked.pop(out) && out.value == 1);
+        }
+        assert(Tracked::live == 0 && "Queue teardown destroys remaining elements");
+    }
+
+    // MPMC under contention: 4 producers, 3 consumers, every value arrives exactly once.
+    {
+        MpmcQueue<int, 64> queue;
+        const ContentionResult r = contention_run(queue, 4, 3, 40'000);
+        assert(r.mitems_per_s > 0.0);
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+    }
+
     return 0;
-}
\ No newline at end of file
+}
@@ -1,5 +1,37 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
 #include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC / Clang need a per-function target to emit AVX2 in a baseline x86-64 build; MSVC does not.
+#if defined(__GNUC__) || defined(__clang__)
+#define KATA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define KATA_TARGET_AVX2
+#endif
 
 /*
 std::optional: https://en.cppreference.com/w/cpp/utility/optional
@@ -8,18 +40,62 @@ enum class: https://en.cppreference.com/w/cpp/language/enum
 
 Motivation: Explicit state transitions with no implicit assumptions.
 Invalid transitions return std::nullopt instead of exceptions or sentinels.
+
+The transitions are written once, as a declarative list of (from, event, to) rules. A dense
+State x Event table is generated from it at compile time, so transition() is one indexed
+load plus a compare; static_asserts check the rules are unambiguous, that every state is
+reachable from parked, and that the table agrees with the original switch.
+
+replay_fleet applies a whole event log at once: structure-of-arrays input (aircraft ids and
+one-byte events) against a per-aircraft state array, with invalid events reported as a
+bitmap plus a compact error list. With AVX2 it gathers 8 states and 8 table entries per step
+(steps with a repeated aircraft id fall back to scalar, to keep per-aircraft order);
+replay_fleet_partitions runs shards with disjoint aircraft on separate threads; each shard
+owns a contiguous range of whole cache lines of states, so threads never share a line.
+
+FlightLegMachine<Handlers...> adds entry / exit / transition / invalid hooks without
+std::function: handlers are a variadic pack stored in the machine, each hook is detected
+with a requires-expression and called directly, so it inlines and an empty pack costs nothing.
+
+Run with --bench for ns/event of the table against the switch on random and realistic
+(mostly happy-path) event streams, the hook machine against bare transition(), then `--bench [M]` replays a synthetic fleet day of
+M million events (default 500).
 */
 
+/*
 Single file main.cpp.
 
-    Define : enum class State { parked,
-                                taxi_out,
-                                takeoff,
-                                cruise,
-                                approach,
-                                landed,
-                                taxi_in };
-enum class Event
+Define:
+enum class State { parked, taxi_out, takeoff, cruise, approach, landed, taxi_in };
+enum class Event { start_taxi, rotate, climb, begin_approach, touchdown, exit_runway, park };
+
+Implement:
+std::optional<State> transition(State s, Event e);
+
+Returns next state if the transition is valid, otherwise std::nullopt.
+
+Valid transitions only:
+parked   + start_taxi     -> taxi_out
+taxi_out + rotate         -> takeoff
+takeoff  + climb          -> cruise
+cruise   + begin_approach -> approach
+approach + touchdown      -> landed
+landed   + exit_runway    -> taxi_in
+taxi_in  + park           -> parked
+*/
+
+enum class State
+{
+    parked,
+    taxi_out,
+    takeoff,
+    cruise,
+    approach,
+    landed,
+    taxi_in
+};
+
+enum class Event : std::uint8_t // one byte per event in bulk logs
 {
     start_taxi,
     rotate,
@@ -30,31 +106,109 @@ enum class Event
     park
 };
 
-Implement : std::optional<State> transition(State s, Event e);
+constexpr std::size_t state_count = static_cast<std::size_t>(State::taxi_in) + 1;
+constexpr std::size_t event_count = static_cast<std::size_t>(Event::park) + 1;
 
-Returns next state if the transition is valid, otherwise std::nullopt.Valid transitions only : parked + start_taxi → taxi_out taxi_out + rotate → takeoff takeoff + climb → cruise cruise + begin_approach → approach approach + touchdown → landed landed + exit_runway → taxi_in taxi_in + park → parked * /
+std::optional<State> transition(State s, Event e);
 
-                                                                                                                                                                                                                                                                                                 enum class State { parked,
-                                                                                                                                                                                                                                                                                                                    taxi_out,
-                                                                                                                                                                                                                                                                                                                    takeoff,
-                                                                                                                                                                                                                                                                                                                    cruise,
-                                                                                                                                                                                                                                                                                                                    approach,
-                                                                                                                                                                                                                                                                                                                    landed,
-                                                                                                                                                                                                                                                                                                                    taxi_in };
-enum class Event
+// Branch-free form of transition: an invalid event keeps the state and clears valid.
+struct Step
 {
-    start_taxi,
-    rotate,
-    climb,
-    begin_approach,
-    touchdown,
-    exit_runway,
-    park
+    State next;
+    bool valid;
 };
+constexpr Step step(State s, Event e);
 
-std::optional<State> transition(State s, Event e);
+// The original nested switch, kept as the reference and benchmark baseline.
+constexpr std::optional<State> transition_switch(State s, Event e);
+
+struct TransitionRule
+{
+    State from;
+    Event event;
+    State to;
+};
+
+// Every valid transition; anything not listed is invalid.
+constexpr TransitionRule transition_rules[] = {
+    {State::parked, Event::start_taxi, State::taxi_out},
+    {State::taxi_out, Event::rotate, State::takeoff},
+    {State::takeoff, Event::climb, State::cruise},
+    {State::cruise, Event::begin_approach, State::approach},
+    {State::approach, Event::touchdown, State::landed},
+    {State::landed, Event::exit_runway, State::taxi_in},
+    {State::taxi_in, Event::park, State::parked},
+};
+
+// Set in a table entry for "no transition"; the low bits then hold the current state.
+constexpr std::uint8_t invalid_bit = 0x80;
+
+// Rows padded to a power of two so the index is a shift and an add.
+constexpr std::size_t table_row = std::bit_ceil(event_count);
+
+// transition_table[state][event]: the next state, or invalid_bit | state.
+constexpr auto transition_table = []
+{
+    std::array<std::array<std::uint8_t, table_row>, state_count> table{};
+    for (std::size_t s = 0; s < state_count; ++s)
+        table[s].fill(static_cast<std::uint8_t>(invalid_bit | s));
+    for (const TransitionRule &r : transition_rules)
+        table[static_cast<std::size_t>(r.from)][static_cast<std::size_t>(r.event)] = static_cast<std::uint8_t>(r.to);
+    return table;
+}();
+
+// No (state, event) pair is listed twice.
+static_assert([]
+              {
+                  for (std::size_t i = 0; i < std::size(transition_rules); ++i)
+                      for (std::size_t j = i + 1; j < std::size(transition_rules); ++j)
+                          if (transition_rules[i].from == transition_rules[j].from &&
+                              transition_rules[i].event == transition_rules[j].event)
+                              return false;
+                  return true;
+              }(),
+              "duplicate transition rule");
+
+// Every state is reachable from parked.
+static_assert([]
+              {
+                  std::array<bool, state_count> reached{};
+                  reached[static_cast<std::size_t>(State::parked)] = true;
+                  for (bool grew = true; grew;)
+                  {
+                      grew = false;
+                      for (const TransitionRule &r : transition_rules)
+                      {
+                          if (reached[static_cast<std::size_t>(r.from)] && !reached[static_cast<std::size_t>(r.to)])
+                          {
+                              reached[static_cast<std::size_t>(r.to)] = true;
+                              grew = true;
+                          }
+                      }
+                  }
+                  for (bool r : reached)
+                      if (!r)
+                          return false;
+                  return true;
+              }(),
+              "unreachable state");
+
+constexpr Step step(State s, Event e)
+{
+    // One indexed load; validity is a bit of the loaded byte, never a jump.
+    const std::uint8_t entry = transition_table[static_cast<std::size_t>(s)][static_cast<std::size_t>(e)];
+    return {static_cast<State>(entry & ~invalid_bit), (entry & invalid_bit) == 0};
+}
 
 std::optional<State> transition(State s, Event e)
+{
+    const Step next = step(s, e);
+    if (!next.valid)
+        return std::nullopt;
+    return next.next;
+}
+
+constexpr std::optional<State> transition_switch(State s, Event e)
 {
     switch (s)
     {
@@ -92,7 +246,669 @@ std::optional<State> transition(State s, Event e)
     return std::nullopt;
 }
 
-int main()
+// The generated table and the hand-written switch agree on all State x Event pairs.
+static_assert([]
+              {
+                  for (std::size_t s = 0; s < state_count; ++s)
+                  {
+                      for (std::size_t e = 0; e < event_count; ++e)
+                      {
+                          const auto expected = transition_switch(static_cast<State>(s), static_cast<Event>(e));
+                          const Step next = step(static_cast<State>(s), static_cast<Event>(e));
+                          if (next.valid != expected.has_value() || next.next != expected.value_or(static_cast<State>(s)))
+                              return false;
+                      }
+                  }
+                  return true;
+              }());
+
+// Random events: each one valid for the current state with probability 1 / event_count.
+std::vector<Event> random_events(std::size_t count, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> event(0, event_count - 1);
+    std::vector<Event> events(count);
+    for (Event &e : events)
+        e = static_cast<Event>(event(rng));
+    return events;
+}
+
+// Coin-flip events: each one valid for the current state with probability 1/2, so a branch
+// on validity is unpredictable. (The valid event for each state has the state's own index.)
+std::vector<Event> coin_flip_events(std::size_t count, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> event(0, event_count - 1);
+    std::bernoulli_distribution valid(0.5);
+    std::vector<Event> events(count);
+    State s = State::parked;
+    for (Event &e : events)
+    {
+        if (valid(rng))
+            e = static_cast<Event>(s);
+        else
+            do
+                e = static_cast<Event>(event(rng));
+            while (e == static_cast<Event>(s));
+        s = transition_switch(s, e).value_or(s);
+    }
+    return events;
+}
+
+// Realistic events: the happy path from parked around the cycle, 1 in 100 replaced by a random event.
+std::vector<Event> realistic_events(std::size_t count, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> event(0, event_count - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<Event> events(count);
+    State s = State::parked;
+    for (Event &e : events)
+    {
+        e = percent(rng) == 0 ? static_cast<Event>(event(rng)) : static_cast<Event>(s);
+        s = transition_switch(s, e).value_or(s);
+    }
+    return events;
+}
+
+struct ReplayResult
+{
+    State final_state;
+    std::size_t invalid;
+};
+
+// Applies events from parked with a Step-returning function; an invalid event leaves the state unchanged.
+template <class StepFn>
+ReplayResult replay(const std::vector<Event> &events, StepFn &&step_fn)
+{
+    State s = State::parked;
+    std::size_t invalid = 0;
+    for (Event e : events)
+    {
+        const Step next = step_fn(s, e);
+        invalid += !next.valid;
+        s = next.next;
+    }
+    return {s, invalid};
+}
+
+// The switch behind the same Step interface.
+constexpr Step step_switch(State s, Event e)
+{
+    const std::optional<State> next = transition_switch(s, e);
+    return {next.value_or(s), next.has_value()};
+}
+
+// ---- Bulk fleet replay ----
+
+struct TransitionError
+{
+    std::size_t index; // position in the event arrays
+    std::uint32_t aircraft;
+    State state; // the state the event was rejected in (and the aircraft stayed in)
+    Event event;
+};
+
+// Applies events[i] to states[aircraft[i]] in order (structure-of-arrays input; every id must
+// be < states.size()). Bit i % 64 of invalid_bits[i / 64] is set when event i is invalid, and
+// each invalid event is appended to errors. Returns the number of invalid events.
+std::size_t replay_fleet(std::span<const std::uint32_t> aircraft, std::span<const Event> events, std::span<State> states,
+                         std::span<std::uint64_t> invalid_bits, std::vector<TransitionError> &errors);
+
+// One shard of a fleet event log: only aircraft of this partition, in time order, plus
+// the replay outputs for those events.
+struct FleetPartition
+{
+    std::vector<std::uint32_t> aircraft;
+    std::vector<Event> events;
+    std::vector<std::uint64_t> invalid_bits;
+    std::vector<TransitionError> errors;
+};
+
+// Replays every partition, up to `threads` at a time. Partitions must not share aircraft,
+// so they can update the shared states array concurrently, and should not share cache lines
+// of it either: give each a contiguous id range of whole 64-byte lines of State (as
+// generate_fleet_events does). Interleaved ids (a % partitions) put a dozen shards on every
+// line, and the threads then spend their time passing lines back and forth.
+std::size_t replay_fleet_partitions(std::span<FleetPartition> partitions, std::span<State> states, unsigned threads);
+
+namespace fleet
+{
+    // Kernels replay events [first, first + count) (count <= 64), write each event's resulting
+    // state to after[k] and return the invalid bits, bit k = event first + k.
+    using Kernel = std::uint64_t (*)(const std::uint32_t *aircraft, const Event *events, State *states,
+                                     std::size_t first, std::size_t count, std::uint8_t *after);
+
+    std::uint64_t replay_scalar(const std::uint32_t *aircraft, const Event *events, State *states, std::size_t first,
+                                std::size_t count, std::uint8_t *after)
+    {
+        std::uint64_t bits = 0;
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            State &s = states[aircraft[first + k]];
+            const Step next = step(s, events[first + k]);
+            s = next.next;
+            after[k] = static_cast<std::uint8_t>(next.next);
+            bits |= std::uint64_t{!next.valid} << k;
+        }
+        return bits;
+    }
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+    // transition_table widened to 32-bit entries for _mm256_i32gather_epi32.
+    constexpr auto table32 = []
+    {
+        std::array<std::int32_t, state_count * table_row> t{};
+        for (std::size_t s = 0; s < state_count; ++s)
+            for (std::size_t e = 0; e < table_row; ++e)
+                t[s * table_row + e] = transition_table[s][e];
+        return t;
+    }();
+
+    // 8 events per step: gather the current states, then the table entries. A step whose 8 ids
+    // are not distinct goes through the scalar loop so same-aircraft events stay in order.
+    KATA_TARGET_AVX2 std::uint64_t replay_avx2(const std::uint32_t *aircraft, const Event *events, State *states,
+                                               std::size_t first, std::size_t count, std::uint8_t *after)
+    {
+        static_assert(sizeof(State) == 4 && sizeof(Event) == 1);
+        const auto *state_words = reinterpret_cast<const int *>(states);
+        const __m256i low_bits = _mm256_set1_epi32(~invalid_bit & 0xFF);
+        const __m256i rotate_one = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+        std::uint64_t bits = 0;
+        std::size_t k = 0;
+        for (; k + 8 <= count; k += 8)
+        {
+            const std::size_t i = first + k;
+            const __m256i ids = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aircraft + i));
+
+            // Any two lanes equal? Compare against the 7 rotations.
+            __m256i rotated = ids;
+            __m256i same = _mm256_setzero_si256();
+            for (int r = 1; r < 8; ++r)
+            {
+                rotated = _mm256_permutevar8x32_epi32(rotated, rotate_one);
+                same = _mm256_or_si256(same, _mm256_cmpeq_epi32(ids, rotated));
+            }
+            if (!_mm256_testz_si256(same, same))
+            {
+                bits |= replay_scalar(aircraft, events, states, i, 8, after + k) << k;
+                continue;
+            }
+
+            const __m256i current = _mm256_i32gather_epi32(state_words, ids, 4);
+            const __m256i ev = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(events + i)));
+            const __m256i index = _mm256_add_epi32(_mm256_slli_epi32(current, std::countr_zero(table_row)), ev);
+            const __m256i entry = _mm256_i32gather_epi32(table32.data(), index, 4);
+
+            // invalid_bit (bit 7) shifted into each lane's sign bit.
+            const auto invalid = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(entry, 24))));
+            bits |= std::uint64_t{invalid} << k;
+
+            // No scatter in AVX2: store the new states lane by lane.
+            alignas(32) std::int32_t next[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(next), _mm256_and_si256(entry, low_bits));
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                states[aircraft[i + lane]] = static_cast<State>(next[lane]);
+                after[k + lane] = static_cast<std::uint8_t>(next[lane]);
+            }
+        }
+        if (k < count)
+            bits |= replay_scalar(aircraft, events, states, first + k, count - k, after + k) << k;
+        return bits;
+    }
+
+    bool cpu_has_avx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+            return false; // OS does not save YMM state
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif
+
+    Kernel best_kernel()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        static const Kernel fn = cpu_has_avx2() ? replay_avx2 : replay_scalar;
+        return fn;
+#else
+        return replay_scalar;
+#endif
+    }
+
+    std::size_t replay(std::span<const std::uint32_t> aircraft, std::span<const Event> events, std::span<State> states,
+                       std::span<std::uint64_t> invalid_bits, std::vector<TransitionError> &errors, Kernel kernel)
+    {
+        const std::size_t n = std::min(aircraft.size(), events.size());
+        assert(invalid_bits.size() >= (n + 63) / 64);
+        assert(std::ranges::all_of(aircraft.first(n), [&](std::uint32_t id) { return id < states.size(); }));
+
+        std::size_t invalid = 0;
+        std::uint8_t after[64];
+        for (std::size_t first = 0; first < n; first += 64)
+        {
+            const std::size_t count = std::min<std::size_t>(64, n - first);
+            const std::uint64_t bits = kernel(aircraft.data(), events.data(), states.data(), first, count, after);
+            invalid_bits[first / 64] = bits;
+            invalid += static_cast<std::size_t>(std::popcount(bits));
+            for (std::uint64_t b = bits; b != 0; b &= b - 1)
+            {
+                const auto k = static_cast<std::size_t>(std::countr_zero(b));
+                errors.push_back({first + k, aircraft[first + k], static_cast<State>(after[k]), events[first + k]});
+            }
+        }
+        return invalid;
+    }
+} // namespace fleet
+
+std::size_t replay_fleet(std::span<const std::uint32_t> aircraft, std::span<const Event> events, std::span<State> states,
+                         std::span<std::uint64_t> invalid_bits, std::vector<TransitionError> &errors)
+{
+    return fleet::replay(aircraft, events, states, invalid_bits, errors, fleet::best_kernel());
+}
+
+std::size_t replay_fleet_partitions(std::span<FleetPartition> partitions, std::span<State> states, unsigned threads)
+{
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> invalid{0};
+    auto worker = [&]
+    {
+        // Partitions are handed out one at a time, so uneven shards still balance.
+        for (std::size_t p = next.fetch_add(1, std::memory_order_relaxed); p < partitions.size();
+             p = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            FleetPartition &part = partitions[p];
+            part.invalid_bits.assign((part.events.size() + 63) / 64, 0);
+            part.errors.clear();
+            invalid.fetch_add(replay_fleet(part.aircraft, part.events, states, part.invalid_bits, part.errors),
+                              std::memory_order_relaxed);
+        }
+    };
+
+    const unsigned workers = std::clamp<unsigned>(threads, 1, static_cast<unsigned>(std::max<std::size_t>(1, partitions.size())));
+    if (workers == 1)
+    {
+        worker();
+    }
+    else
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve(workers);
+        for (unsigned t = 0; t < workers; ++t)
+            pool.emplace_back(worker);
+    }
+    return invalid.load();
+}
+
+// Synthetic day of fleet events: `aircraft` aircraft in `partitions` shards, each shard a
+// contiguous id range of fleet_shard_span() ids. Each event picks a random aircraft and sends
+// its next happy-path event; 1 in noise_ppm / 1'000'000 events is replaced by a random event.
+// Ids per shard: an even split rounded up to whole 64-byte lines of State.
+std::size_t fleet_shard_span(std::uint32_t aircraft, std::size_t partitions)
+{
+    constexpr std::size_t states_per_line = 64 / sizeof(State);
+    const std::size_t even = (aircraft + partitions - 1) / partitions;
+    return (even + states_per_line - 1) / states_per_line * states_per_line;
+}
+
+std::vector<FleetPartition> generate_fleet_events(std::size_t events, std::uint32_t aircraft, std::size_t partitions,
+                                                  std::uint32_t noise_ppm, std::uint64_t seed)
+{
+    const std::size_t span = fleet_shard_span(aircraft, partitions);
+    std::vector<FleetPartition> shards(partitions);
+    for (FleetPartition &shard : shards)
+    {
+        shard.aircraft.reserve(events / partitions + events / partitions / 8 + 64);
+        shard.events.reserve(shard.aircraft.capacity());
+    }
+    std::vector<State> expected(aircraft, State::parked);
+
+    // A 64-bit LCG: mt19937 dominates the run time at hundreds of millions of events.
+    std::uint64_t x = seed * 2 + 1;
+    auto next = [&x]
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<std::uint32_t>(x >> 32);
+    };
+    for (std::size_t i = 0; i < events; ++i)
+    {
+        const std::uint32_t id = static_cast<std::uint32_t>((std::uint64_t{next()} * aircraft) >> 32);
+        State &s = expected[id];
+        // The happy-path event for each state has the state's own index.
+        Event e = static_cast<Event>(s);
+        if (next() % 1'000'000 < noise_ppm)
+            e = static_cast<Event>(next() % event_count);
+        s = step(s, e).next;
+        FleetPartition &shard = shards[id / span];
+        shard.aircraft.push_back(id);
+        shard.events.push_back(e);
+    }
+    return shards;
+}
+
+// ---- Transition hooks ----
+
+// A flight-leg state machine with side effects bound at compile time. Each handler may define
+// any of
+//   void on_exit(State from);
+//   void on_transition(State from, Event e, State to);
+//   void on_enter(State to);
+//   void on_invalid(State s, Event e);
+// and dispatch() calls exactly the ones that exist, in that order (all exits, then all
+// transitions, then all enters), directly rather than through a pointer, so they inline. With
+// no handlers, dispatch() is step() plus a store.
+template <class... Handlers>
+class FlightLegMachine
+{
+public:
+    FlightLegMachine() = default;
+    explicit FlightLegMachine(Handlers... handlers)
+        requires(sizeof...(Handlers) > 0);
+    FlightLegMachine(State initial, Handlers... handlers);
+
+    // Same result as transition(state(), e); on success the state advances.
+    std::optional<State> dispatch(Event e);
+
+    State state() const;
+
+    template <class Handler>
+    Handler &handler();
+
+private:
+    template <class F>
+    void for_each_handler(F &&f);
+
+    State state_ = State::parked;
+    [[no_unique_address]] std::tuple<Handlers...> handlers_;
+};
+
+template <class... Handlers>
+FlightLegMachine<Handlers...>::FlightLegMachine(Handlers... handlers)
+    requires(sizeof...(Handlers) > 0)
+    : handlers_(std::move(handlers)...)
+{
+}
+
+template <class... Handlers>
+FlightLegMachine<Handlers...>::FlightLegMachine(State initial, Handlers... handlers)
+    : state_(initial), handlers_(std::move(handlers)...)
+{
+}
+
+template <class... Handlers>
+std::optional<State> FlightLegMachine<Handlers...>::dispatch(Event e)
+{
+    const State from = state_;
+    const Step next = step(from, e);
+    if (!next.valid)
+    {
+        for_each_handler([&](auto &h) {
+            if constexpr (requires { h.on_invalid(from, e); })
+                h.on_invalid(from, e);
+        });
+        return std::nullopt;
+    }
+
+    const State to = next.next;
+    for_each_handler([&](auto &h) {
+        if constexpr (requires { h.on_exit(from); })
+            h.on_exit(from);
+    });
+    for_each_handler([&](auto &h) {
+        if constexpr (requires { h.on_transition(from, e, to); })
+            h.on_transition(from, e, to);
+    });
+    state_ = to;
+    for_each_handler([&](auto &h) {
+        if constexpr (requires { h.on_enter(to); })
+            h.on_enter(to);
+    });
+    return to;
+}
+
+template <class... Handlers>
+State FlightLegMachine<Handlers...>::state() const
+{
+    return state_;
+}
+
+template <class... Handlers>
+template <class Handler>
+Handler &FlightLegMachine<Handlers...>::handler()
+{
+    return std::get<Handler>(handlers_);
+}
+
+template <class... Handlers>
+template <class F>
+void FlightLegMachine<Handlers...>::for_each_handler(F &&f)
+{
+    std::apply([&](auto &...h) { (f(h), ...); }, handlers_);
+}
+
+// No handlers, no storage beyond the state.
+static_assert(sizeof(FlightLegMachine<>) == sizeof(State));
+
+// Example handlers: a takeoff timer and a telemetry flush on landing.
+struct TakeoffTimer
+{
+    std::chrono::steady_clock::time_point started{};
+    int starts = 0;
+
+    void on_enter(State to)
+    {
+        if (to == State::takeoff)
+        {
+            started = std::chrono::steady_clock::now();
+            ++starts;
+        }
+    }
+};
+
+struct TelemetryFlush
+{
+    int pending = 0; // samples buffered since the last flush
+    int flushes = 0;
+
+    void on_transition(State, Event, State) { ++pending; }
+
+    void on_enter(State to)
+    {
+        if (to == State::landed)
+        {
+            ++flushes;
+            pending = 0;
+        }
+    }
+};
+
+// Replays a synthetic fleet day (`million_events` M events, 40k aircraft, 16 shards) per kernel
+// on one thread, then across shards on all hardware threads.
+void bench_fleet(std::size_t million_events)
+{
+    constexpr std::uint32_t aircraft = 40'000;
+    constexpr std::size_t shards = 16;
+    const std::size_t total = million_events * 1'000'000;
+    std::vector<FleetPartition> day = generate_fleet_events(total, aircraft, shards, 1'000, 16);
+    std::vector<State> states(aircraft);
+
+    auto timed = [&](auto &&run)
+    {
+        std::ranges::fill(states, State::parked);
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t invalid = run();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return std::pair{elapsed.count(), invalid};
+    };
+    auto one_thread = [&](fleet::Kernel kernel)
+    {
+        return [&, kernel]
+        {
+            std::size_t invalid = 0;
+            for (FleetPartition &part : day)
+            {
+                part.invalid_bits.assign((part.events.size() + 63) / 64, 0);
+                part.errors.clear();
+                invalid += fleet::replay(part.aircraft, part.events, states, part.invalid_bits, part.errors, kernel);
+            }
+            return invalid;
+        };
+    };
+    auto report = [&](const std::string &name, std::pair<double, std::size_t> r)
+    {
+        std::cout << "  " << name << ": " << r.first << " s, " << static_cast<double>(total) / r.first / 1e6 << " M events/s ("
+                  << r.second << " invalid)\n";
+    };
+
+    std::cout << "Fleet replay: " << million_events << "M events, " << aircraft << " aircraft, " << shards << " shards\n";
+    const auto scalar = timed(one_thread(fleet::replay_scalar));
+    report("scalar, 1 thread     ", scalar);
+#if defined(__x86_64__) || defined(_M_X64)
+    if (fleet::cpu_has_avx2())
+    {
+        const auto gather = timed(one_thread(fleet::replay_avx2));
+        assert(gather.second == scalar.second);
+        report("AVX2 gather, 1 thread", gather);
+    }
+#endif
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    const auto parallel = timed([&] { return replay_fleet_partitions(day, states, threads); });
+    assert(parallel.second == scalar.second);
+    report("best, " + std::to_string(threads) + " thread(s)   ", parallel);
+}
+
+// Counts entries per state; the cheapest hook that still has an observable effect.
+struct EnterCounter
+{
+    std::array<std::uint64_t, state_count> entered{};
+
+    void on_enter(State to) { ++entered[static_cast<std::size_t>(to)]; }
+};
+
+// ns/event on a realistic stream: bare transition(), the machine with no hooks, the machine
+// with one counting hook, and the same hook as a std::function.
+void bench_hooks()
+{
+    constexpr std::size_t count = std::size_t{1} << 24;
+    const std::vector<Event> events = realistic_events(count, 17);
+
+    auto ns_per_event = [&](auto &&run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t invalid = run();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return std::pair{elapsed.count() / static_cast<double>(count), invalid};
+    };
+
+    const auto bare = ns_per_event(
+        [&]
+        {
+            State s = State::parked;
+            std::size_t invalid = 0;
+            for (Event e : events)
+            {
+                if (const std::optional<State> next = transition(s, e))
+                    s = *next;
+                else
+                    ++invalid;
+            }
+            return invalid;
+        });
+    const auto empty = ns_per_event(
+        [&]
+        {
+            FlightLegMachine<> machine;
+            std::size_t invalid = 0;
+            for (Event e : events)
+                invalid += !machine.dispatch(e).has_value();
+            return invalid;
+        });
+    const auto counted = ns_per_event(
+        [&]
+        {
+            FlightLegMachine<EnterCounter> machine;
+            std::size_t invalid = 0;
+            for (Event e : events)
+                invalid += !machine.dispatch(e).has_value();
+            return invalid;
+        });
+    const auto function = ns_per_event(
+        [&]
+        {
+            EnterCounter counter;
+            const std::function<void(State)> on_enter = [&counter](State to) { counter.on_enter(to); };
+            State s = State::parked;
+            std::size_t invalid = 0;
+            for (Event e : events)
+            {
+                if (const std::optional<State> next = transition(s, e))
+                {
+                    s = *next;
+                    on_enter(s);
+                }
+                else
+                {
+                    ++invalid;
+                }
+            }
+            return invalid;
+        });
+    assert(bare.second == empty.second && bare.second == counted.second && bare.second == function.second);
+
+    std::cout << "Transition hooks, " << count << " realistic events (ns/event)\n";
+    std::cout << "  bare transition()          : " << bare.first << "\n";
+    std::cout << "  FlightLegMachine<>         : " << empty.first << "\n";
+    std::cout << "  FlightLegMachine<counter>  : " << counted.first << "\n";
+    std::cout << "  std::function counter hook : " << function.first << "\n";
+}
+
+void run_benchmarks()
+{
+    constexpr std::size_t count = std::size_t{1} << 24;
+
+    auto ns_per_event = [](const std::vector<Event> &events, auto &&transition_fn, ReplayResult &result)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        result = replay(events, transition_fn);
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(events.size());
+    };
+
+    const std::pair<const char *, std::vector<Event>> streams[] = {
+        {"random   ", random_events(count, 15)},
+        {"coin flip", coin_flip_events(count, 15)},
+        {"realistic", realistic_events(count, 15)},
+    };
+    std::cout << "Replaying " << count << " events (ns/event)\n";
+    for (const auto &[name, events] : streams)
+    {
+        ReplayResult by_switch{};
+        ReplayResult by_table{};
+        // Lambdas rather than function pointers, so both versions inline into the replay loop.
+        const double switch_ns = ns_per_event(events, [](State s, Event e) { return step_switch(s, e); }, by_switch);
+        const double table_ns = ns_per_event(events, [](State s, Event e) { return step(s, e); }, by_table);
+        assert(by_switch.final_state == by_table.final_state && by_switch.invalid == by_table.invalid);
+        std::cout << "  " << name << "  switch: " << switch_ns << "  table: " << table_ns << "  (" << by_table.invalid
+                  << " invalid)\n";
+    }
+    bench_hooks();
+}
+
+int main(int argc, char **argv)
 {
 
     // Test valid transition
@@ -109,5 +925,128 @@ int main()
     assert(transition(State::cruise, Event::rotate) == std::nullopt);
     assert(transition(State::taxi_in, Event::begin_approach) == std::nullopt);
 
+    // Table and switch agree at run time too, over every pair and over replayed streams.
+    for (std::size_t s = 0; s < state_count; ++s)
+        for (std::size_t e = 0; e < event_count; ++e)
+            assert(transition(static_cast<State>(s), static_cast<Event>(e)) ==
+                   transition_switch(static_cast<State>(s), static_cast<Event>(e)));
+    {
+        const std::vector<Event> events = realistic_events(10'000, 1);
+        const ReplayResult a = replay(events, step);
+        const ReplayResult b = replay(events, step_switch);
+        assert(a.final_state == b.final_state && a.invalid == b.invalid);
+    }
+
+    // Bulk replay matches event-by-event replay with the switch, for both kernels, with
+    // few aircraft (many same-aircraft events inside one 8-wide step) and with many.
+    for (std::uint32_t fleet_size : {3u, 500u})
+    {
+        std::vector<FleetPartition> day = generate_fleet_events(20'011, fleet_size, 1, 50'000, fleet_size);
+        const FleetPartition &log = day[0];
+
+        std::vector<State> expected(fleet_size, State::parked);
+        std::vector<TransitionError> expected_errors;
+        for (std::size_t i = 0; i < log.events.size(); ++i)
+        {
+            State &s = expected[log.aircraft[i]];
+            const std::optional<State> next = transition_switch(s, log.events[i]);
+            if (!next)
+                expected_errors.push_back({i, log.aircraft[i], s, log.events[i]});
+            s = next.value_or(s);
+        }
+
+        auto check = [&](fleet::Kernel kernel)
+        {
+            std::vector<State> states(fleet_size, State::parked);
+            std::vector<std::uint64_t> bits((log.events.size() + 63) / 64);
+            std::vector<TransitionError> errors;
+            const std::size_t invalid = fleet::replay(log.aircraft, log.events, states, bits, errors, kernel);
+            assert(states == expected && invalid == expected_errors.size() && errors.size() == invalid);
+            for (std::size_t k = 0; k < invalid; ++k)
+            {
+                const TransitionError &a = errors[k];
+                const TransitionError &b = expected_errors[k];
+                assert(a.index == b.index && a.aircraft == b.aircraft && a.state == b.state && a.event == b.event);
+                assert((bits[a.index / 64] >> (a.index % 64)) & 1);
+            }
+            std::size_t set = 0;
+            for (std::uint64_t w : bits)
+                set += static_cast<std::size_t>(std::popcount(w));
+            assert(set == invalid);
+        };
+        check(fleet::replay_scalar);
+#if defined(__x86_64__) || defined(_M_X64)
+        if (fleet::cpu_has_avx2())
+            check(fleet::replay_avx2);
+#endif
+    }
+
+    // Sharded replay over several threads gives the same states and error count.
+    {
+        std::vector<FleetPartition> day = generate_fleet_events(50'000, 1'000, 5, 10'000, 7);
+        std::vector<State> one(1'000, State::parked);
+        std::vector<State> many(1'000, State::parked);
+        const std::size_t a = replay_fleet_partitions(day, one, 1);
+        const std::size_t b = replay_fleet_partitions(day, many, 3);
+        assert(a == b && one == many && a > 0);
+        std::size_t listed = 0;
+        for (const FleetPartition &part : day)
+            listed += part.errors.size();
+        assert(listed == a);
+
+        // Each shard owns whole cache lines of states: no line is written by two shards.
+        const std::size_t span = fleet_shard_span(1'000, 5);
+        assert(span * sizeof(State) % 64 == 0);
+        for (std::size_t p = 0; p < day.size(); ++p)
+            assert(std::ranges::all_of(day[p].aircraft, [&](std::uint32_t id) { return id / span == p; }));
+    }
+
+    // Hooks: bound at compile time, called in exit -> transition -> enter order, and only
+    // for the hooks a handler defines.
+    {
+        struct Recorder
+        {
+            std::string log;
+            void on_exit(State) { log += 'x'; }
+            void on_transition(State, Event, State) { log += 't'; }
+            void on_enter(State) { log += 'e'; }
+            void on_invalid(State, Event) { log += '!'; }
+        };
+
+        FlightLegMachine machine{TakeoffTimer{}, TelemetryFlush{}, Recorder{}};
+        for (int leg = 0; leg < 2; ++leg)
+        {
+            for (Event e : {Event::start_taxi, Event::rotate, Event::climb, Event::begin_approach, Event::touchdown,
+                            Event::exit_runway, Event::park})
+                assert(machine.dispatch(e).has_value());
+        }
+        assert(machine.dispatch(Event::touchdown) == std::nullopt);
+        assert(machine.state() == State::parked);
+        assert(machine.handler<TakeoffTimer>().starts == 2);
+        assert(machine.handler<TelemetryFlush>().flushes == 2 && machine.handler<TelemetryFlush>().pending == 2);
+        std::string expected;
+        for (int i = 0; i < 14; ++i)
+            expected += "xte";
+        assert(machine.handler<Recorder>().log == expected + "!");
+
+        // Without handlers the machine tracks transition() exactly.
+        FlightLegMachine<> bare(State::cruise);
+        assert(bare.dispatch(Event::rotate) == transition(State::cruise, Event::rotate));
+        assert(bare.dispatch(Event::begin_approach) == State::approach && bare.state() == State::approach);
+    }
+
+    std::cout << "All tests passed!\n";
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+
+        // Optional fleet-day size in millions of events (default 500).
+        std::size_t million_events = 500;
+        if (argc > 2)
+            million_events = std::strtoull(argv[2], nullptr, 10);
+        bench_fleet(million_events);
+    }
+
     return 0;
-}
\ No newline at end of file
+}
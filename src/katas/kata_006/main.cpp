@@ -1,14 +1,42 @@
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cctype>
 #include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
+#include <random>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// POSIX file mapping for the observation-log scanner (MappedFile and the file bench only;
+// the in-memory scanner and everything else build on every preset).
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /*std::optional: https://en.cppreference.com/w/cpp/utility/optional
 std::nullopt: https://en.cppreference.com/w/cpp/utility/optional/nullopt
 std::from_chars: https://en.cppreference.com/w/cpp/utility/from_chars
+std::expected: https://en.cppreference.com/w/cpp/utility/expected
 std::string_view: https://en.cppreference.com/w/cpp/string/basic_string_view
 std::isdigit: https://en.cppreference.com/w/cpp/string/byte/isdigit
 operator->: https://en.cppreference.com/w/cpp/utility/optional/operator*
@@ -16,6 +44,24 @@ has_value: https://en.cppreference.com/w/cpp/utility/optional/has_value
 
 Motivation: Explicit boundary API using std::optional to signal that data may be missing.
 No exceptions, no sentinels, no implicit assumptions.
+
+parse_wind extends the accepted grammar to real wind groups (27015G25KT, VRB03KT,
+18008MPS, plus the original DDD/SS) and returns std::expected with the reason for a
+rejection. It is a DFA whose tables are built at compile time: one lookup per character,
+no heap, no exceptions. parse_wx is parse_wind with the reason dropped.
+
+parse_wx_batch is the bulk form for archived feeds: fixed-width records in, columns of
+direction / speed plus a validity bitmap out, accepting exactly what parse_wx accepts.
+scan_observations ingests a whole observation log: the file is memory-mapped, split into
+lines in place (string_views into the mapping, no copies) and each line goes to parse_wx.
+Threads take byte ranges whose boundaries are moved to line starts; accepted samples land
+in one contiguous WxSample array in file order, and write_samples dumps that array raw.
+The mapping (MappedFile) and the file bench need POSIX mmap; the in-memory scanner builds
+everywhere.
+
+Run with --bench for records/s against a parse_wx loop and ns per token for parse_wind
+against the original 6-character parser; `--bench [MB]` then ingests a generated log
+(2 GB by default) with ifstream + getline and with the mapped scanner.
 */
 
 /*C++20 Daily Kata: std::optional as a Boundary Type
@@ -78,13 +124,221 @@ No extra logging
 
 struct WxSample
 {
-    int wind_dir_deg; // 0..360
-    int wind_kt;      // >= 0
+    int wind_dir_deg; // 0..360 (0 when variable)
+    int wind_kt;      // >= 0, knots (MPS reports are converted)
+    std::uint16_t gust_kt = 0; // meaningful only when has_gust
+    bool has_gust = false;
+    bool variable = false; // "VRB": no mean direction
+
+    friend constexpr bool operator==(const WxSample &, const WxSample &) = default;
 };
 
+// Why parse_wind rejected a token.
+enum class WxError : std::uint8_t
+{
+    empty,
+    bad_direction,          // not 3 digits or "VRB"
+    direction_out_of_range, // above 360
+    bad_speed,              // not 2-3 digits (2 in the "DDD/SS" form)
+    bad_gust,               // 'G' not followed by 2-3 digits
+    bad_unit,               // not "KT" / "MPS"
+    trailing_characters,    // anything after a complete group
+};
+
+// Wind group, no whitespace:
+//   (DDD | VRB) FF[F] [G FF[F]] (KT | MPS)    e.g. 27015KT, 27015G25KT, VRB03KT, 18008MPS
+//   DDD/SS                                    the original fixed 6-character form
+// Exception- and heap-free; constexpr.
+constexpr std::expected<WxSample, WxError> parse_wind(std::string_view token);
+
 std::optional<WxSample> parse_wx(std::string_view line);
 
+// The original 6-character "DDD/SS" parser, kept as the benchmark baseline.
+std::optional<WxSample> parse_wx_fixed6(std::string_view line);
+
+// A DFA over character classes. The transition and class tables are generated at compile
+// time from the edge list below; each entry is the next state, accept, or the WxError to
+// report, so the parser runs one table lookup per character and never backtracks.
+namespace wind_dfa
+{
+    enum Class : std::uint8_t
+    {
+        digit, V, R, B, G, K, T, M, P, S, slash, other, end, class_count
+    };
+
+    enum State : std::uint8_t
+    {
+        start,
+        d1, d2, d3,        // direction digits
+        v, vr, vrb,        // "VRB"
+        s1, s2, s3,        // speed digits
+        g, g1, g2, g3,     // gust
+        k, kt, m, mp, mps, // unit
+        l, l1, l2,         // "DDD/" then SS
+        state_count
+    };
+
+    // Entries below state_count are states; accept, then accept + 1 + WxError are final.
+    constexpr std::uint8_t accept = state_count;
+
+    constexpr std::uint8_t fail(WxError e)
+    {
+        return static_cast<std::uint8_t>(accept + 1 + static_cast<std::uint8_t>(e));
+    }
+
+    // Which value a digit read into each state feeds: 0 none, 1 dir, 2 speed, 3 gust.
+    constexpr auto field_of = []
+    {
+        std::array<std::uint8_t, state_count> f{};
+        for (State st : {d1, d2, d3})
+            f[st] = 1;
+        for (State st : {s1, s2, s3, l1, l2})
+            f[st] = 2;
+        for (State st : {g1, g2, g3})
+            f[st] = 3;
+        return f;
+    }();
+
+    constexpr auto class_of = []
+    {
+        std::array<std::uint8_t, 256> c{};
+        c.fill(other);
+        for (int ch = '0'; ch <= '9'; ++ch)
+            c[ch] = digit;
+        const std::pair<char, Class> letters[] = {{'V', V}, {'R', R}, {'B', B}, {'G', G}, {'K', K},
+                                                  {'T', T}, {'M', M}, {'P', P}, {'S', S}, {'/', slash}};
+        for (const auto &[ch, cls] : letters)
+            c[static_cast<unsigned char>(ch)] = cls;
+        return c;
+    }();
+
+    constexpr auto table = []
+    {
+        std::array<std::array<std::uint8_t, class_count>, state_count> t{};
+
+        // Default: the error a state reports for any character (or end) without an edge.
+        auto fail_all = [&](State st, WxError e) { t[st].fill(fail(e)); };
+        fail_all(start, WxError::bad_direction);
+        t[start][end] = fail(WxError::empty);
+        for (State st : {d1, d2, v, vr})
+            fail_all(st, WxError::bad_direction);
+        for (State st : {d3, vrb, s1, l, l1})
+            fail_all(st, WxError::bad_speed);
+        for (State st : {s2, s3, g2, g3, k, m, mp})
+            fail_all(st, WxError::bad_unit);
+        for (State st : {g, g1})
+            fail_all(st, WxError::bad_gust);
+        for (State st : {kt, mps, l2})
+        {
+            fail_all(st, WxError::trailing_characters);
+            t[st][end] = accept;
+        }
+        t[s3][digit] = fail(WxError::bad_speed);
+        t[g3][digit] = fail(WxError::bad_gust);
+
+        auto edge = [&](State from, Class c, State to) { t[from][c] = to; };
+        edge(start, digit, d1);
+        edge(d1, digit, d2);
+        edge(d2, digit, d3);
+        edge(start, V, v);
+        edge(v, R, vr);
+        edge(vr, B, vrb);
+        edge(d3, digit, s1);
+        edge(vrb, digit, s1);
+        edge(s1, digit, s2);
+        edge(s2, digit, s3);
+        edge(d3, slash, l);
+        edge(l, digit, l1);
+        edge(l1, digit, l2);
+        edge(s2, G, g);
+        edge(s3, G, g);
+        edge(g, digit, g1);
+        edge(g1, digit, g2);
+        edge(g2, digit, g3);
+        for (State st : {s2, s3, g2, g3})
+        {
+            edge(st, K, k);
+            edge(st, M, m);
+        }
+        edge(k, T, kt);
+        edge(m, P, mp);
+        edge(mp, S, mps);
+        return t;
+    }();
+
+    // The class lookup folded in, so each character costs one dependent load: [state][byte].
+    constexpr auto byte_table = []
+    {
+        std::array<std::array<std::uint8_t, 256>, state_count> t{};
+        for (std::size_t st = 0; st < state_count; ++st)
+            for (std::size_t ch = 0; ch < 256; ++ch)
+                t[st][ch] = table[st][class_of[ch]];
+        return t;
+    }();
+
+    // Every state has at least one edge to another state or to accept.
+    static_assert([]
+                  {
+                      for (const auto &row : table)
+                          if (std::ranges::none_of(row, [](std::uint8_t e) { return e <= accept; }))
+                              return false;
+                      return true;
+                  }());
+} // namespace wind_dfa
+
+constexpr std::expected<WxSample, WxError> parse_wind(std::string_view token)
+{
+    using namespace wind_dfa;
+    std::uint32_t dir = 0, speed = 0, gust = 0;
+    std::uint32_t seen = 0; // bit per state visited
+    std::uint8_t st = start;
+    for (const char ch : token)
+    {
+        const auto byte = static_cast<unsigned char>(ch);
+        const std::uint8_t next = byte_table[st][byte];
+        if (next >= accept)
+            return std::unexpected(static_cast<WxError>(next - accept - 1));
+        st = next;
+        // Selects rather than an indexed array, so the accumulators stay in registers.
+        const std::uint8_t field = field_of[st];
+        const std::uint32_t d = byte - static_cast<std::uint32_t>('0');
+        dir = field == 1 ? dir * 10 + d : dir;
+        speed = field == 2 ? speed * 10 + d : speed;
+        gust = field == 3 ? gust * 10 + d : gust;
+        seen |= std::uint32_t{1} << st;
+    }
+    if (const std::uint8_t final = table[st][end]; final != accept)
+        return std::unexpected(static_cast<WxError>(final - accept - 1));
+
+    const bool variable = (seen >> vrb) & 1;
+    if (!variable && dir > 360)
+        return std::unexpected(WxError::direction_out_of_range);
+
+    // 1 m/s = 1.943844 kt, rounded to the nearest knot.
+    const auto knots = [mps = st == wind_dfa::mps](std::uint32_t speed)
+    { return mps ? (speed * 1'943'844 + 500'000) / 1'000'000 : speed; };
+    WxSample sample{static_cast<int>(dir), static_cast<int>(knots(speed))};
+    sample.has_gust = (seen >> g) & 1;
+    sample.gust_kt = static_cast<std::uint16_t>(knots(gust));
+    sample.variable = variable;
+    return sample;
+}
+
+static_assert(parse_wind("27015G25KT") == WxSample{270, 15, 25, true, false});
+static_assert(parse_wind("VRB03KT") == WxSample{0, 3, 0, false, true});
+static_assert(parse_wind("18008MPS") == WxSample{180, 16});
+static_assert(parse_wind("090/12") == WxSample{90, 12});
+static_assert(parse_wind("361/10") == std::unexpected(WxError::direction_out_of_range));
+static_assert(parse_wind("27015G5KT") == std::unexpected(WxError::bad_gust));
+
 std::optional<WxSample> parse_wx(std::string_view line)
+{
+    if (const auto sample = parse_wind(line))
+        return *sample;
+    return std::nullopt;
+}
+
+std::optional<WxSample> parse_wx_fixed6(std::string_view line)
 {
 
     /*
@@ -105,7 +359,7 @@ std::optional<WxSample> parse_wx(std::string_view line)
     {
         if (i == 3)
             continue; // skip separator
-        if (!std::isdigit(line[i]))
+        if (!std::isdigit(static_cast<unsigned char>(line[i])))
             return std::nullopt;
     }
 
@@ -131,7 +385,568 @@ std::optional<WxSample> parse_wx(std::string_view line)
     return WxSample{wind_dir_deg, wind_kt};
 }
 
-int main()
+// Bulk decode of fixed-width records: record i is the 6 bytes at buffer[i * stride]
+// (stride >= 6; bytes 6..stride-1, typically '\n', are not inspected). The final record
+// needs no trailing padding. Writes dir[i] / kt[i] (0 when invalid) and sets bit i % 8 of
+// valid[i / 8] exactly when parse_wx would accept the record. Returns the number of records
+// decoded: all of them, or as many as the output spans hold (whole bitmap bytes).
+std::size_t parse_wx_batch(std::string_view buffer, std::size_t stride, std::span<std::int16_t> dir,
+                           std::span<std::uint8_t> kt, std::span<std::uint8_t> valid);
+
+namespace wx_swar
+{
+    // Little-endian record "DDD/SS" xor "000/00": digit bytes become 0..9, the separator 0.
+    constexpr std::uint64_t pattern = 0x0000'3030'2F30'3030;
+    // Bits that must be clear: high nibbles of digit bytes, all of the separator byte.
+    constexpr std::uint64_t high_bits = 0x0000'F0F0'FFF0'F0F0;
+    // Adding 6 to a digit byte carries into 0x10 exactly when it is above 9.
+    constexpr std::uint64_t plus_six = 0x0000'0606'0006'0606;
+    constexpr std::uint64_t carry_bits = 0x0000'1010'0010'1010;
+
+    struct Decoded
+    {
+        std::int16_t dir;
+        std::uint8_t kt;
+        bool ok;
+    };
+
+    inline std::uint64_t load_record(const char *p)
+    {
+        // Only the 6 record bytes (the last record may end the buffer), as two loads that
+        // the CPU can forward directly; a 6-byte memcpy into a zeroed word stalls on the store.
+        std::uint32_t lo;
+        std::uint16_t hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 2);
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            lo = std::byteswap(lo);
+            hi = std::byteswap(hi);
+        }
+        return lo | (std::uint64_t{hi} << 32);
+    }
+
+    inline Decoded decode(std::uint64_t record)
+    {
+        const std::uint64_t t = record ^ pattern;
+        const auto digit = [t](int byte) { return static_cast<unsigned>((t >> (8 * byte)) & 0x0F); };
+        const unsigned d = digit(0) * 100 + digit(1) * 10 + digit(2);
+        const unsigned s = digit(4) * 10 + digit(5);
+        // Bitwise & keeps the validity test free of branches.
+        const bool ok = (((t & high_bits) | ((t + plus_six) & carry_bits)) == 0) & (d <= 360);
+        // Invalid records store 0 / 0; masking instead of ?: keeps GCC from branching.
+        const unsigned keep = 0u - static_cast<unsigned>(ok);
+        return {static_cast<std::int16_t>(d & keep), static_cast<std::uint8_t>(s & keep), ok};
+    }
+} // namespace wx_swar
+
+std::size_t parse_wx_batch(std::string_view buffer, std::size_t stride, std::span<std::int16_t> dir,
+                           std::span<std::uint8_t> kt, std::span<std::uint8_t> valid)
+{
+    assert(stride >= 6);
+    const std::size_t records = buffer.size() < 6 ? 0 : (buffer.size() - 6) / stride + 1;
+    const std::size_t n = std::min({records, dir.size(), kt.size(), valid.size() * 8});
+    const char *p = buffer.data();
+
+    // 8 records per step, one bitmap byte each.
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        std::uint8_t bits = 0;
+        for (std::size_t k = 0; k < 8; ++k)
+        {
+            const wx_swar::Decoded r = wx_swar::decode(wx_swar::load_record(p + (i + k) * stride));
+            dir[i + k] = r.dir;
+            kt[i + k] = r.kt;
+            bits |= static_cast<std::uint8_t>(r.ok << k);
+        }
+        valid[i / 8] = bits;
+    }
+
+    if (i < n)
+    {
+        std::uint8_t bits = 0; // bits past n stay clear
+        for (std::size_t k = 0; i + k < n; ++k)
+        {
+            const wx_swar::Decoded r = wx_swar::decode(wx_swar::load_record(p + (i + k) * stride));
+            dir[i + k] = r.dir;
+            kt[i + k] = r.kt;
+            bits |= static_cast<std::uint8_t>(r.ok << k);
+        }
+        valid[i / 8] = bits;
+    }
+    return n;
+}
+
+// Records of the form "DDD/SS\n": ~90% valid, the rest with one corrupted byte.
+std::string make_wx_records(std::size_t count, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dir(0, 360);
+    std::uniform_int_distribution<int> kt(0, 99);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> pos(0, 5);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::string buffer;
+    buffer.reserve(count * 7);
+    char record[8];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::snprintf(record, sizeof(record), "%03d/%02d", dir(rng), kt(rng));
+        if (percent(rng) < 10)
+        {
+            record[pos(rng)] = static_cast<char>(byte(rng));
+        }
+        buffer.append(record, 6);
+        buffer += '\n';
+    }
+    return buffer;
+}
+
+// Checks every record of buffer against parse_wx.
+void check_batch_matches_parse_wx(std::string_view buffer, std::size_t stride)
+{
+    const std::size_t records = buffer.size() < 6 ? 0 : (buffer.size() - 6) / stride + 1;
+    std::vector<std::int16_t> dir(records);
+    std::vector<std::uint8_t> kt(records);
+    std::vector<std::uint8_t> valid((records + 7) / 8);
+    assert(parse_wx_batch(buffer, stride, dir, kt, valid) == records);
+
+    for (std::size_t i = 0; i < records; ++i)
+    {
+        const auto expected = parse_wx(buffer.substr(i * stride, 6));
+        const bool ok = (valid[i / 8] >> (i % 8)) & 1;
+        assert(ok == expected.has_value());
+        assert(dir[i] == (expected ? expected->wind_dir_deg : 0));
+        assert(kt[i] == (expected ? expected->wind_kt : 0));
+    }
+    if (records % 8 != 0)
+    {
+        assert((valid.back() >> (records % 8)) == 0);
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// Read-only mapping of a whole file (POSIX mmap). Move-only; an empty file gives an empty view.
+class MappedFile
+{
+public:
+    static std::optional<MappedFile> open(const char *path);
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    std::string_view view() const;
+
+    // Drops the whole pages inside [offset, offset + len) from this process's resident set.
+    // They stay in the page cache and fault back in if touched again.
+    void release(std::size_t offset, std::size_t len) const;
+
+private:
+    MappedFile(char *base, std::size_t size);
+
+    char *base_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+std::optional<MappedFile> MappedFile::open(const char *path)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return std::nullopt;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void *base = nullptr;
+    if (size > 0)
+    {
+        base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED)
+        {
+            ::close(fd);
+            return std::nullopt;
+        }
+        ::madvise(base, size, MADV_SEQUENTIAL);
+    }
+    // The mapping keeps the file referenced; the descriptor is no longer needed.
+    ::close(fd);
+    return MappedFile(static_cast<char *>(base), size);
+}
+
+MappedFile::MappedFile(char *base, std::size_t size) : base_(base), size_(size) {}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : base_(std::exchange(other.base_, nullptr)), size_(std::exchange(other.size_, 0))
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (base_ != nullptr)
+            ::munmap(base_, size_);
+        base_ = std::exchange(other.base_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    if (base_ != nullptr)
+        ::munmap(base_, size_);
+}
+
+std::string_view MappedFile::view() const
+{
+    return {base_, size_};
+}
+
+void MappedFile::release(std::size_t offset, std::size_t len) const
+{
+    static const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(base_ + offset);
+    const auto end = reinterpret_cast<std::uintptr_t>(base_ + offset + len);
+    const std::uintptr_t first = (begin + page - 1) & ~(page - 1);
+    const std::uintptr_t last = end & ~(page - 1);
+    if (first < last)
+        ::madvise(reinterpret_cast<void *>(first), last - first, MADV_DONTNEED);
+}
+#endif
+
+// Samples of every line parse_wx accepts, in file order, stored contiguously.
+struct ScanResult
+{
+    std::unique_ptr<WxSample[]> samples;
+    std::size_t count = 0;
+    std::size_t lines = 0;    // '\n'-separated lines (a trailing '\n' does not start one)
+    std::size_t rejected = 0; // lines parse_wx returned nullopt for
+
+    std::span<const WxSample> view() const { return {samples.get(), count}; }
+};
+
+// Splits data into lines in place and parses each with parse_wx, using up to `threads`
+// threads on line-aligned byte ranges.
+ScanResult scan_observations(std::string_view data, unsigned threads);
+
+#if defined(__unix__) || defined(__APPLE__)
+// Same over a mapped file; pages are released from the resident set as they are consumed.
+ScanResult scan_observations(const MappedFile &file, unsigned threads);
+#endif
+
+// Writes samples as a raw WxSample array. False on any I/O failure.
+bool write_samples(const char *path, std::span<const WxSample> samples);
+
+namespace wx_scan
+{
+    // Each thread drops what it has read every `release_window` bytes.
+    constexpr std::size_t release_window = std::size_t{4} << 20;
+
+    struct Part
+    {
+        std::size_t begin, end; // line-aligned byte range
+        std::size_t out;        // first output slot
+        std::size_t count = 0, lines = 0, rejected = 0;
+    };
+
+    template <class Release>
+    void scan_part(std::string_view data, Part &part, WxSample *out, Release &&release)
+    {
+        const char *const base = data.data();
+        const char *p = base + part.begin;
+        const char *const end = base + part.end;
+        const char *released = p;
+        while (p < end)
+        {
+            const auto *nl = static_cast<const char *>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+            const char *line_end = nl != nullptr ? nl : end;
+            ++part.lines;
+            if (const auto sample = parse_wx(std::string_view(p, static_cast<std::size_t>(line_end - p))))
+                out[part.count++] = *sample;
+            else
+                ++part.rejected;
+            p = nl != nullptr ? nl + 1 : end;
+
+            if (static_cast<std::size_t>(p - released) >= release_window)
+            {
+                release(static_cast<std::size_t>(released - base), static_cast<std::size_t>(p - released));
+                released = p;
+            }
+        }
+    }
+
+    template <class Release>
+    ScanResult scan(std::string_view data, unsigned threads, Release &&release)
+    {
+        const std::size_t size = data.size();
+        threads = std::max(1u, threads);
+
+        // Cut at k * size / threads, then move each cut forward to the next line start.
+        std::vector<Part> parts;
+        std::size_t begin = 0;
+        std::size_t out = 0;
+        for (unsigned k = 1; k <= threads && begin < size; ++k)
+        {
+            std::size_t end = k == threads ? size : std::max(begin, size / threads * k);
+            if (end < size && end > 0 && data[end - 1] != '\n')
+            {
+                const std::size_t nl = data.find('\n', end);
+                end = nl == std::string_view::npos ? size : nl + 1;
+            }
+            if (end == begin)
+                continue;
+            parts.push_back({begin, end, out});
+            // The shortest line parse_wx accepts (DDD/SS) is 6 bytes plus '\n' (or the end); wind
+            // groups are longer, so this bounds the range's samples.
+            out += (end - begin) / 7 + 1;
+            begin = end;
+        }
+
+        ScanResult result;
+        result.samples = std::make_unique_for_overwrite<WxSample[]>(out);
+        WxSample *const samples = result.samples.get();
+        if (parts.size() == 1)
+        {
+            scan_part(data, parts[0], samples, release);
+        }
+        else
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(parts.size());
+            for (Part &part : parts)
+                workers.emplace_back([&, samples] { scan_part(data, part, samples + part.out, release); });
+        }
+
+        // Close the gaps left by each range's upper bound, keeping file order.
+        for (const Part &part : parts)
+        {
+            if (part.out != result.count)
+                std::memmove(samples + result.count, samples + part.out, part.count * sizeof(WxSample));
+            result.count += part.count;
+            result.lines += part.lines;
+            result.rejected += part.rejected;
+        }
+        return result;
+    }
+} // namespace wx_scan
+
+ScanResult scan_observations(std::string_view data, unsigned threads)
+{
+    return wx_scan::scan(data, threads, [](std::size_t, std::size_t) {});
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+ScanResult scan_observations(const MappedFile &file, unsigned threads)
+{
+    return wx_scan::scan(file.view(), threads, [&file](std::size_t offset, std::size_t len) { file.release(offset, len); });
+}
+#endif
+
+bool write_samples(const char *path, std::span<const WxSample> samples)
+{
+    std::FILE *f = std::fopen(path, "wb");
+    if (f == nullptr)
+        return false;
+    const bool written = std::fwrite(samples.data(), sizeof(WxSample), samples.size(), f) == samples.size();
+    return (std::fclose(f) == 0) && written;
+}
+
+// Reference: split with find, parse each line.
+std::vector<WxSample> scan_reference(std::string_view data, std::size_t &lines)
+{
+    std::vector<WxSample> samples;
+    lines = 0;
+    while (!data.empty())
+    {
+        const std::size_t end = std::min(data.find('\n'), data.size());
+        ++lines;
+        if (const auto s = parse_wx(data.substr(0, end)))
+            samples.push_back(*s);
+        data.remove_prefix(std::min(end + 1, data.size()));
+    }
+    return samples;
+}
+
+bool same_samples(std::span<const WxSample> a, std::span<const WxSample> b)
+{
+    return std::ranges::equal(a, b);
+}
+
+// ns per token: the original 6-character parser against the DFA, on the same 6-character
+// tokens and on a mix of full wind groups.
+void bench_wind_grammar()
+{
+    constexpr std::size_t count = 1 << 16;
+    constexpr int reps = 64;
+    const std::string records = make_wx_records(count, 14);
+    std::vector<std::string_view> fixed6(count);
+    for (std::size_t i = 0; i < count; ++i)
+        fixed6[i] = std::string_view(records).substr(i * 7, 6);
+
+    const std::string_view groups[] = {"27015KT", "27015G25KT", "VRB03KT", "18008MPS", "090/12", "360105G120KT", "2701KT"};
+    std::vector<std::string_view> mixed(count);
+    std::mt19937 rng(15);
+    std::uniform_int_distribution<std::size_t> pick(0, std::size(groups) - 1);
+    for (std::string_view &t : mixed)
+        t = groups[pick(rng)];
+
+    auto ns_per_token = [&](const std::vector<std::string_view> &tokens, auto &&parse)
+    {
+        long long sink = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+            for (std::string_view t : tokens)
+                if (const auto s = parse(t))
+                    sink += s->wind_kt;
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        volatile long long keep = sink;
+        (void)keep;
+        return elapsed.count() / (static_cast<double>(count) * reps);
+    };
+
+    std::cout << "Wind token parsing (ns/token)\n";
+    std::cout << "  parse_wx_fixed6, DDD/SS     : " << ns_per_token(fixed6, parse_wx_fixed6) << "\n";
+    std::cout << "  parse_wind,      DDD/SS     : " << ns_per_token(fixed6, parse_wind) << "\n";
+    std::cout << "  parse_wind,      mixed group: " << ns_per_token(mixed, parse_wind) << "\n";
+}
+
+void run_benchmarks()
+{
+    constexpr std::size_t count = std::size_t{1} << 24;
+    const std::string buffer = make_wx_records(count, 12);
+    std::vector<std::int16_t> dir(count);
+    std::vector<std::uint8_t> kt(count);
+    std::vector<std::uint8_t> valid(count / 8);
+
+    auto records_per_s = [&](auto &&fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(count) / elapsed.count();
+    };
+
+    const double scalar = records_per_s(
+        [&]
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto r = parse_wx(std::string_view(buffer).substr(i * 7, 6));
+                dir[i] = static_cast<std::int16_t>(r ? r->wind_dir_deg : 0);
+                kt[i] = static_cast<std::uint8_t>(r ? r->wind_kt : 0);
+                valid[i / 8] = static_cast<std::uint8_t>((valid[i / 8] & ~(1u << (i % 8))) | (unsigned{r.has_value()} << (i % 8)));
+            }
+        });
+    const double batch = records_per_s([&] { parse_wx_batch(buffer, 7, dir, kt, valid); });
+
+    std::cout << "Decoding " << count << " records (" << buffer.size() / (1 << 20) << " MB)\n";
+    std::cout << "  parse_wx loop : " << scalar / 1e6 << " M records/s\n";
+    std::cout << "  parse_wx_batch: " << batch / 1e6 << " M records/s\n";
+
+    bench_wind_grammar();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// Peak resident set (VmHWM) since the last reset_peak_rss(); 0 where /proc is unavailable.
+std::size_t peak_rss_mb()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.starts_with("VmHWM:"))
+            return std::strtoull(line.c_str() + 6, nullptr, 10) / 1024;
+    }
+    return 0;
+}
+
+void reset_peak_rss()
+{
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+// Ingests a generated observation log of `file_mb` MB: ifstream + getline against mmap + threads.
+void bench_file_ingest(std::size_t file_mb)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "kata_006_obs.log").string();
+    {
+        // Written in 1 MB blocks from the record generator, reusing one block per write.
+        std::FILE *f = std::fopen(path.c_str(), "wb");
+        if (f == nullptr)
+        {
+            std::cout << "Cannot create " << path << "\n";
+            return;
+        }
+        for (std::size_t mb = 0; mb < file_mb; ++mb)
+        {
+            const std::string block = make_wx_records((std::size_t{1} << 20) / 7, static_cast<std::uint32_t>(mb));
+            std::fwrite(block.data(), 1, block.size(), f);
+        }
+        std::fclose(f);
+    }
+    const auto file_bytes = static_cast<double>(std::filesystem::file_size(path));
+
+    auto timed = [](auto &&fn)
+    {
+        reset_peak_rss();
+        const auto start = std::chrono::steady_clock::now();
+        auto result = fn();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return std::tuple{std::move(result), elapsed.count(), peak_rss_mb()};
+    };
+
+    std::size_t baseline_count = 0;
+    {
+        auto [samples, seconds, rss] = timed(
+            [&]
+            {
+                std::vector<WxSample> out;
+                out.reserve(static_cast<std::size_t>(file_bytes) / 7 + 1);
+                std::ifstream in(path);
+                std::string line;
+                while (std::getline(in, line))
+                {
+                    if (const auto s = parse_wx(line))
+                        out.push_back(*s);
+                }
+                return out;
+            });
+        baseline_count = samples.size();
+        std::cout << "Ingesting " << file_mb << " MB (" << samples.size() << " samples)\n";
+        std::cout << "  ifstream + getline    : " << file_bytes / seconds / 1e9 << " GB/s, peak RSS " << rss << " MB\n";
+    }
+
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    auto [result, seconds, rss] = timed(
+        [&]
+        {
+            const auto file = MappedFile::open(path.c_str());
+            return file ? std::optional(scan_observations(*file, threads)) : std::nullopt;
+        });
+    if (!result)
+    {
+        std::cout << "Cannot map " << path << "\n";
+        std::filesystem::remove(path);
+        return;
+    }
+    assert(result->count == baseline_count);
+    std::cout << "  mmap, " << threads << " thread(s)      : " << file_bytes / seconds / 1e9 << " GB/s, peak RSS " << rss
+              << " MB\n";
+    std::filesystem::remove(path);
+}
+#endif
+
+int main(int argc, char **argv)
 {
 
     std::cout << "Testing parse_wx function\n"
@@ -166,5 +981,161 @@ int main()
     assert(parse_wx("090/12 ") == std::nullopt); // whitespace
     assert(parse_wx("09A/12") == std::nullopt);  // non-digit
 
+    // Full wind group grammar, with the reason for each rejection.
+    {
+        assert(parse_wind("27015KT") == (WxSample{270, 15}));
+        assert(parse_wind("270105KT") == (WxSample{270, 105}));
+        assert(parse_wind("27015G125KT") == (WxSample{270, 15, 125, true, false}));
+        assert(parse_wind("VRB03KT") == (WxSample{0, 3, 0, false, true}));
+        assert(parse_wind("VRB12G20KT") == (WxSample{0, 12, 20, true, true}));
+        assert(parse_wind("36010MPS") == (WxSample{360, 19}));
+        assert(parse_wind("00000KT") == (WxSample{0, 0}));
+
+        const std::pair<std::string_view, WxError> rejected[] = {
+            {"", WxError::empty},
+            {"90/12", WxError::bad_direction},
+            {"VR03KT", WxError::bad_direction},
+            {"361/10", WxError::direction_out_of_range},
+            {"99915KT", WxError::direction_out_of_range},
+            {"090/1", WxError::bad_speed},
+            {"090-12", WxError::bad_speed},
+            {"2705KT", WxError::bad_speed},
+            {"2701234KT", WxError::bad_speed},
+            {"VRBKT", WxError::bad_speed},
+            {"27015", WxError::bad_unit},
+            {"27015KMH", WxError::bad_unit},
+            {"27015kt", WxError::bad_unit},
+            {"27015G25", WxError::bad_unit},
+            {"27015GKT", WxError::bad_gust},
+            {"27015G2500KT", WxError::bad_gust},
+            {"090/12 ", WxError::trailing_characters},
+            {"27015KTZ", WxError::trailing_characters},
+            {" 27015KT", WxError::bad_direction},
+        };
+        for (const auto &[token, error] : rejected)
+        {
+            assert(parse_wind(token) == std::unexpected(error));
+            assert(!parse_wx(token).has_value());
+        }
+
+        // Anything the original 6-character parser accepts parses identically; on 6-byte
+        // tokens the two agree exactly (every new form is at least 7 characters).
+        std::mt19937 rng(14);
+        const char alphabet[] = "0123456789012345/GKTMPSVRB ";
+        std::uniform_int_distribution<std::size_t> pick(0, sizeof(alphabet) - 2);
+        std::uniform_int_distribution<int> length(0, 12);
+        std::string token;
+        for (int i = 0; i < 50'000; ++i)
+        {
+            token.clear();
+            const int len = i % 2 == 0 ? 6 : length(rng);
+            for (int k = 0; k < len; ++k)
+                token += alphabet[pick(rng)];
+            const auto fixed = parse_wx_fixed6(token);
+            if (fixed || token.size() == 6)
+                assert(parse_wx(token) == fixed);
+        }
+    }
+
+    // Batch decoder agrees with parse_wx record by record.
+    {
+        // Adversarial records: neighbours of '0'..'9' and '/', range edges, high bytes.
+        const std::string_view cases[] = {"090/12", "360/00", "000/99", "361/10", "999/99", "359/99", "09A/12", "090-12",
+                                          "090/1 ", " 90/12", "/90/12", "090//2", ":00/00", "00:/00", "000.00", "000/:0",
+                                          "000/0/", "\xB0\xB0\xB0/00", "000/\xFF\xFF", std::string_view("000\0/00", 6),
+                                          "370/00", "400/00", "36:/00", "3600/0"};
+        std::string joined;
+        for (std::string_view c : cases)
+        {
+            joined += c;
+            joined += '\n';
+        }
+        check_batch_matches_parse_wx(joined, 7);
+        joined.pop_back(); // last record without its newline
+        check_batch_matches_parse_wx(joined, 7);
+
+        // Random records at several strides, counts not a multiple of 8.
+        check_batch_matches_parse_wx(make_wx_records(10'001, 1), 7);
+        std::mt19937 rng(6);
+        std::uniform_int_distribution<int> byte(0, 255);
+        for (std::size_t stride : {6, 8, 13})
+        {
+            std::string noise(stride * 997 + 6, '\0');
+            for (std::size_t i = 0; i < noise.size(); ++i)
+            {
+                // Mostly digits so that a fair share of records is valid.
+                const int b = byte(rng);
+                noise[i] = b < 200 ? static_cast<char>('0' + b % 10) : static_cast<char>(b);
+                if (i % stride == 3 && b < 230)
+                {
+                    noise[i] = '/';
+                }
+            }
+            check_batch_matches_parse_wx(noise, stride);
+        }
+
+        // Output spans bound the count.
+        std::int16_t dir[3];
+        std::uint8_t kt[3];
+        std::uint8_t valid[1];
+        assert(parse_wx_batch("001/01\n002/02\n003/03\n004/04\n", 7, dir, kt, valid) == 3);
+        assert(valid[0] == 0b111 && dir[2] == 3 && kt[2] == 3);
+    }
+
+    // Line scanner: any thread count gives the reference split, in order.
+    {
+        std::string log = make_wx_records(5'000, 7);
+        log += "\n\n090/12\r\n360/00\nnot a sample\n000/99"; // empty lines, CRLF, no final newline
+        std::size_t lines = 0;
+        const std::vector<WxSample> expected = scan_reference(log, lines);
+        for (unsigned threads : {1u, 2u, 3u, 8u, 64u})
+        {
+            const ScanResult r = scan_observations(log, threads);
+            assert(r.lines == lines && r.rejected == lines - expected.size());
+            assert(same_samples(r.view(), expected));
+        }
+        assert(scan_observations("", 4).count == 0 && scan_observations("\n", 4).lines == 1);
+
+#if defined(__unix__) || defined(__APPLE__)
+        // Through a mapped file, then a samples file round trip.
+        const std::string path = (std::filesystem::temp_directory_path() / "kata_006_test.log").string();
+        const std::string bin = path + ".bin";
+        {
+            std::ofstream(path, std::ios::binary) << log;
+            auto file = MappedFile::open(path.c_str());
+            assert(file.has_value() && file->view() == log);
+            const ScanResult r = scan_observations(*file, 3);
+            assert(same_samples(r.view(), expected));
+
+            MappedFile moved = std::move(*file);
+            assert(moved.view() == log && file->view().empty());
+
+            assert(write_samples(bin.c_str(), r.view()));
+            std::vector<WxSample> back(r.count);
+            std::ifstream in(bin, std::ios::binary);
+            in.read(reinterpret_cast<char *>(back.data()), static_cast<std::streamsize>(back.size() * sizeof(WxSample)));
+            assert(in && same_samples(back, expected));
+        }
+        std::filesystem::remove(path);
+        std::filesystem::remove(bin);
+        assert(!MappedFile::open(path.c_str()).has_value());
+#endif
+    }
+
+    std::cout << "All tests passed!\n";
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+
+#if defined(__unix__) || defined(__APPLE__)
+        // Optional size of the generated observation log in MB (default 2 GB).
+        std::size_t file_mb = 2048;
+        if (argc > 2)
+            std::from_chars(argv[2], argv[2] + std::strlen(argv[2]), file_mb);
+        bench_file_ingest(file_mb);
+#endif
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -1,8 +1,23 @@
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cctype>
 #include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <expected>
+#include <new>
+#include <random>
+#include <span>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
 /*
 Task
@@ -64,8 +79,41 @@ Use std::expected
 No exceptions
 No logging
 
+Fast path
+
+Every valid token is 2..4 bytes, so parse_percent loads the whole token into one 32-bit word
+(two overlapping 2-byte loads), right-aligns it with '0' padding so it always reads
+"DDD%", and checks the '%' and all three digits with a couple of integer operations. The
+value is three multiply-adds. There is one predictable branch on the size and one on the
+result; building the error is a separate cold, out-of-line function, so the hot path stays
+small enough to inline into a caller's loop. parse_percent_batch runs the same kernel over
+many tokens, writing values and error codes into parallel spans.
+
+parse_percent_from_chars is the original isdigit + from_chars version, kept as the reference
+and as the benchmark baseline.
+
+Structured errors
+
+Bulk jobs need to know where a field failed, not just why. ParseError packs the ParseErr
+code, the field's byte offset in the input (40 bits) and its index within the record
+(16 bits) into one 64-bit word, so std::expected<int, ParseError> is 16 bytes that come back
+in a register pair, like the plain ParseErr version. ErrorSink counts
+every failure per code and keeps the first N in caller-provided storage: no heap traffic,
+however many lines fail.
+
+Run with --bench for ns/token on 0%, 10% and 50% invalid mixes, then the happy-path cost of
+parse_percent_field + ErrorSink against parse_percent.
+
 */
 
+#if defined(__GNUC__) || defined(__clang__)
+#define KATA_COLD [[gnu::cold, gnu::noinline]]
+#elif defined(_MSC_VER)
+#define KATA_COLD __declspec(noinline)
+#else
+#define KATA_COLD
+#endif
+
 enum class ParseErr
 {
     empty,
@@ -73,9 +121,199 @@ enum class ParseErr
     out_of_range
 };
 
+constexpr std::size_t parse_err_count = 3;
+
+// Where and why a field failed, packed into one word: code in bits 0..7, field index in
+// bits 8..23, byte offset in bits 24..63 (offsets up to 1 TB, field indices up to 65535).
+class ParseError
+{
+public:
+    constexpr ParseError() = default;
+    constexpr ParseError(ParseErr code, std::uint64_t offset, std::uint16_t field);
+
+    constexpr ParseErr code() const;
+    constexpr std::uint64_t offset() const;
+    constexpr std::uint16_t field() const;
+
+    friend constexpr bool operator==(const ParseError &, const ParseError &) = default;
+
+private:
+    std::uint64_t bits_ = 0;
+};
+
+constexpr ParseError::ParseError(ParseErr code, std::uint64_t offset, std::uint16_t field)
+    : bits_(static_cast<std::uint64_t>(code) | std::uint64_t{field} << 8 | offset << 24)
+{
+}
+
+constexpr ParseErr ParseError::code() const
+{
+    return static_cast<ParseErr>(bits_ & 0xFF);
+}
+
+constexpr std::uint64_t ParseError::offset() const
+{
+    return bits_ >> 24;
+}
+
+constexpr std::uint16_t ParseError::field() const
+{
+    return static_cast<std::uint16_t>(bits_ >> 8);
+}
+
+static_assert(sizeof(std::expected<int, ParseError>) <= 16, "expected<int, ParseError> must fit a register pair");
+// What the calling convention looks at (expected's assignment is never trivial).
+static_assert(std::is_trivially_copy_constructible_v<std::expected<int, ParseError>> &&
+              std::is_trivially_move_constructible_v<std::expected<int, ParseError>> &&
+              std::is_trivially_destructible_v<std::expected<int, ParseError>>);
+static_assert(ParseError(ParseErr::out_of_range, (std::uint64_t{1} << 40) - 1, 65535).offset() ==
+              (std::uint64_t{1} << 40) - 1);
+
+// Counts every recorded failure per code and keeps the first storage.size() of them, in
+// order, in caller-provided storage. Never allocates.
+class ErrorSink
+{
+public:
+    explicit ErrorSink(std::span<ParseError> storage);
+
+    void record(ParseError error);
+    void clear();
+
+    std::span<const ParseError> first() const;
+    std::uint64_t count(ParseErr code) const;
+    std::uint64_t total() const;
+
+private:
+    std::span<ParseError> storage_;
+    std::size_t kept_ = 0;
+    std::array<std::uint64_t, parse_err_count> counts_{};
+};
+
 std::expected<int, ParseErr> parse_percent(std::string_view s);
+std::expected<int, ParseErr> parse_percent_from_chars(std::string_view s);
+
+// Writes values[i] (-1 if tokens[i] is invalid) and errors[i] (only meaningful where
+// values[i] == -1) for every token; spans must be at least tokens.size(). Returns the
+// number of invalid tokens.
+std::size_t parse_percent_batch(std::span<const std::string_view> tokens, std::span<int> values,
+                                std::span<ParseErr> errors);
+
+// parse_percent for field `field` of a record, starting `offset` bytes into the input.
+std::expected<int, ParseError> parse_percent_field(std::string_view s, std::uint64_t offset, std::uint16_t field);
+
+// Parses lines of comma-separated percentage fields. values[i] gets the i-th field in input
+// order (-1 if invalid; values needs room for every field) and each failure goes to sink
+// with its byte offset in text and field index within its line. Returns the field count.
+// Every ',' ends a field and starts another, and every line has at least one field, so
+// "5%," and "5%,\n" both end in an empty field and a blank line is one empty field; only a
+// final '\n' starts nothing.
+std::size_t parse_percent_records(std::string_view text, std::span<int> values, ErrorSink &sink);
+
+namespace percent_detail
+{
+// A 2..4 byte token as a little-endian word, right-aligned and padded with leading '0's:
+// byte 3 is the last character, bytes 0..2 the (up to) three characters before it.
+inline std::uint32_t load_token(const char *p, std::size_t size)
+{
+    std::uint16_t head;
+    std::uint16_t tail;
+    std::memcpy(&head, p, 2);
+    std::memcpy(&tail, p + size - 2, 2);
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        head = std::byteswap(head);
+        tail = std::byteswap(tail);
+    }
+    // Overlapping loads: for size 2 both are the same bytes, for 3 they share one. The shifts
+    // by size are multiplies by table entries (variable shifts cost more than a multiply).
+    static constexpr std::uint32_t tail_scale[5] = {0, 0, 1, 1u << 8, 1u << 16};
+    static constexpr std::uint32_t pad_scale[5] = {0, 0, 1u << 16, 1u << 8, 1};
+    static constexpr std::uint32_t pad_zeros[5] = {0, 0, 0x3030, 0x30, 0};
+    return (head | tail * tail_scale[size]) * pad_scale[size] + pad_zeros[size];
+}
+
+// Three digit values (0..9 when valid) in bytes 0..2.
+inline std::uint32_t digits(std::uint32_t word)
+{
+    return (word ^ 0x303030) & 0xFFFFFF;
+}
+
+// '%' last and three digits before it. A byte above 9 sets its high bit after adding 0x76
+// (or already had it set); carries out of an invalid byte only hit bytes that do not matter.
+inline bool well_formed(std::uint32_t word)
+{
+    const std::uint32_t d = digits(word);
+    return (word >> 24) == '%' && (((d + 0x767676) | d) & 0x808080) == 0;
+}
+
+inline int value(std::uint32_t word)
+{
+    const std::uint32_t d = digits(word);
+    return static_cast<int>((d & 0xF) * 100 + (d >> 8 & 0xF) * 10 + (d >> 16 & 0xF));
+}
+} // namespace percent_detail
+
+// Only failing tokens get here: the size alone separates empty from bad_format, and a
+// well-formed token can only fail on its range.
+constexpr ParseErr percent_error_code(std::size_t size, bool well_formed)
+{
+    if (size == 0)
+    {
+        return ParseErr::empty;
+    }
+    return well_formed ? ParseErr::out_of_range : ParseErr::bad_format;
+}
+
+KATA_COLD std::expected<int, ParseErr> percent_error(std::size_t size, bool well_formed)
+{
+    return std::unexpected(percent_error_code(size, well_formed));
+}
 
 std::expected<int, ParseErr> parse_percent(std::string_view s)
+{
+    const std::size_t size = s.size();
+    if (size - 2 > 2) [[unlikely]]
+    {
+        return percent_error(size, false);
+    }
+    const std::uint32_t word = percent_detail::load_token(s.data(), size);
+    const bool well_formed = percent_detail::well_formed(word);
+    const int value = percent_detail::value(word);
+    if (!well_formed || value > 100) [[unlikely]]
+    {
+        return percent_error(size, well_formed);
+    }
+    return value;
+}
+
+std::size_t parse_percent_batch(std::span<const std::string_view> tokens, std::span<int> values,
+                                std::span<ParseErr> errors)
+{
+    assert(values.size() >= tokens.size() && errors.size() >= tokens.size());
+    std::size_t invalid = 0;
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        const std::size_t size = tokens[i].size();
+        if (size - 2 > 2) [[unlikely]]
+        {
+            values[i] = -1;
+            errors[i] = percent_error_code(size, false);
+            ++invalid;
+            continue;
+        }
+        // No early exit: the error code and value are selected, not branched on.
+        const std::uint32_t word = percent_detail::load_token(tokens[i].data(), size);
+        const bool well_formed = percent_detail::well_formed(word);
+        const int value = percent_detail::value(word);
+        const bool ok = well_formed & (value <= 100);
+        values[i] = ok ? value : -1;
+        errors[i] = well_formed ? ParseErr::out_of_range : ParseErr::bad_format;
+        invalid += !ok;
+    }
+    return invalid;
+}
+
+std::expected<int, ParseErr> parse_percent_from_chars(std::string_view s)
 {
     // Check for empty string
     if (s.empty())
@@ -123,7 +361,341 @@ std::expected<int, ParseErr> parse_percent(std::string_view s)
     return value;
 }
 
-int main()
+KATA_COLD std::expected<int, ParseError> field_error(std::size_t size, bool well_formed, std::uint64_t offset,
+                                                     std::uint16_t field)
+{
+    return std::unexpected(ParseError(percent_error_code(size, well_formed), offset, field));
+}
+
+// Same kernel as parse_percent rather than a call to it: the position is only touched on
+// the cold path, so the happy path costs what parse_percent does.
+std::expected<int, ParseError> parse_percent_field(std::string_view s, std::uint64_t offset, std::uint16_t field)
+{
+    const std::size_t size = s.size();
+    if (size - 2 > 2) [[unlikely]]
+    {
+        return field_error(size, false, offset, field);
+    }
+    const std::uint32_t word = percent_detail::load_token(s.data(), size);
+    const bool well_formed = percent_detail::well_formed(word);
+    const int value = percent_detail::value(word);
+    if (!well_formed || value > 100) [[unlikely]]
+    {
+        return field_error(size, well_formed, offset, field);
+    }
+    return value;
+}
+
+std::size_t parse_percent_records(std::string_view text, std::span<int> values, ErrorSink &sink)
+{
+    std::size_t count = 0;
+    std::uint16_t field = 0;
+    std::size_t begin = 0;
+    while (begin < text.size() || (begin == text.size() && begin > 0 && text[begin - 1] == ','))
+    {
+        std::size_t end = begin;
+        while (end < text.size() && text[end] != ',' && text[end] != '\n')
+        {
+            ++end;
+        }
+
+        const auto value = parse_percent_field(text.substr(begin, end - begin), begin, field);
+        assert(count < values.size() && "values needs room for every field");
+        if (value) [[likely]]
+        {
+            values[count] = *value;
+        }
+        else
+        {
+            values[count] = -1;
+            sink.record(value.error());
+        }
+        ++count;
+
+        field = end < text.size() && text[end] == '\n' ? 0 : field + 1;
+        begin = end + 1;
+    }
+    return count;
+}
+
+ErrorSink::ErrorSink(std::span<ParseError> storage) : storage_(storage)
+{
+}
+
+void ErrorSink::record(ParseError error)
+{
+    ++counts_[static_cast<std::size_t>(error.code())];
+    if (kept_ < storage_.size())
+    {
+        storage_[kept_++] = error;
+    }
+}
+
+void ErrorSink::clear()
+{
+    kept_ = 0;
+    counts_ = {};
+}
+
+std::span<const ParseError> ErrorSink::first() const
+{
+    return storage_.first(kept_);
+}
+
+std::uint64_t ErrorSink::count(ParseErr code) const
+{
+    return counts_[static_cast<std::size_t>(code)];
+}
+
+std::uint64_t ErrorSink::total() const
+{
+    std::uint64_t sum = 0;
+    for (std::uint64_t c : counts_)
+    {
+        sum += c;
+    }
+    return sum;
+}
+
+// Counts global allocations so main() can show that error reporting never touches the heap.
+std::size_t allocation_count = 0;
+
+void *operator new(std::size_t size)
+{
+    ++allocation_count;
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        std::abort();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// Every string of up to 5 characters over digits, '%' and the bytes that border the digit
+// range, checked against parse_percent_from_chars, one at a time and in one batch.
+void check_matches_reference()
+{
+    constexpr std::string_view alphabet = "0123456789%/: a\xB0";
+    std::vector<std::string> strings{""};
+    for (std::size_t begin = 0, length = 1; length <= 5; ++length)
+    {
+        const std::size_t end = strings.size();
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            for (char c : alphabet)
+            {
+                strings.push_back(strings[i] + c);
+            }
+        }
+        begin = end;
+    }
+
+    std::vector<std::string_view> tokens(strings.begin(), strings.end());
+    std::vector<int> values(tokens.size());
+    std::vector<ParseErr> errors(tokens.size());
+    std::size_t expected_invalid = 0;
+    const std::size_t invalid = parse_percent_batch(tokens, values, errors);
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+        const auto expected = parse_percent_from_chars(tokens[i]);
+        assert(parse_percent(tokens[i]) == expected);
+        if (expected)
+        {
+            assert(values[i] == *expected);
+        }
+        else
+        {
+            assert(values[i] == -1 && errors[i] == expected.error());
+            ++expected_invalid;
+        }
+    }
+    assert(invalid == expected_invalid);
+}
+
+// `count` device-status percentage tokens, `invalid_percent` of them malformed or out of range,
+// packed into `text` as lines of eight comma-separated fields.
+std::vector<std::string_view> make_percent_tokens(std::string &text, std::size_t count, int invalid_percent,
+                                                  unsigned seed)
+{
+    static constexpr std::string_view bad[] = {"", "10", "10 %", "abc%", "101%", "250%", "1x%", "%", "1000%"};
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> value(0, 100);
+    std::uniform_int_distribution<std::size_t> pick(0, std::size(bad) - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> ranges(count);
+    text.clear();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto &[offset, size] = ranges[i];
+        offset = text.size();
+        text += percent(rng) < invalid_percent ? std::string(bad[pick(rng)]) : std::to_string(value(rng)) + '%';
+        size = text.size() - offset;
+        text += i % 8 == 7 ? '\n' : ',';
+    }
+    std::vector<std::string_view> tokens;
+    tokens.reserve(count);
+    for (const auto &[offset, size] : ranges)
+    {
+        tokens.push_back(std::string_view(text).substr(offset, size));
+    }
+    return tokens;
+}
+
+// ns/token for the reference, parse_percent in a loop and parse_percent_batch.
+void run_benchmarks()
+{
+    constexpr std::size_t count = 1 << 18;
+    constexpr int reps = 64;
+
+    std::printf("%8s %12s %14s %12s  (ns/token)\n", "invalid", "from_chars", "parse_percent", "batch");
+    for (int invalid_percent : {0, 10, 50})
+    {
+        std::string text;
+        const std::vector<std::string_view> tokens = make_percent_tokens(text, count, invalid_percent, 21);
+        std::vector<int> values(count);
+        std::vector<ParseErr> errors(count);
+
+        auto ns_per_token = [&](auto &&parse_all)
+        {
+            long long sink = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r)
+            {
+                sink += parse_all();
+            }
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            volatile long long keep = sink;
+            (void)keep;
+            return elapsed.count() / (count * reps);
+        };
+        auto loop = [&](auto &&parse)
+        {
+            return [&]
+            {
+                long long sum = 0;
+                for (std::string_view token : tokens)
+                {
+                    const auto r = parse(token);
+                    sum += r ? *r : static_cast<int>(r.error()) + 1000;
+                }
+                return sum;
+            };
+        };
+
+        const double reference = ns_per_token(loop([](std::string_view t) { return parse_percent_from_chars(t); }));
+        const double fast = ns_per_token(loop([](std::string_view t) { return parse_percent(t); }));
+        const double batch = ns_per_token(
+            [&]
+            {
+                const std::size_t invalid = parse_percent_batch(tokens, values, errors);
+                return static_cast<long long>(invalid) + values[invalid % count];
+            });
+        std::printf("%7d%% %12.2f %14.2f %12.2f\n", invalid_percent, reference, fast, batch);
+    }
+}
+
+// ns/field with error reporting: parse_percent counting bare ParseErr codes, against
+// parse_percent_field feeding an ErrorSink with offsets and field indices, and the whole
+// record parser (field splitting included). The first two columns run the same loop over
+// the same precomputed offsets and field indices, so they differ only in the parse call and
+// what a failure records.
+void bench_error_reporting()
+{
+    constexpr std::size_t count = 1 << 18;
+    constexpr int reps = 64;
+    std::array<ParseError, 64> storage;
+
+    std::printf("%8s %14s %14s %14s  (ns/field)\n", "invalid", "parse_percent", "field + sink", "records");
+    for (int invalid_percent : {0, 10, 50})
+    {
+        std::string text;
+        const std::vector<std::string_view> tokens = make_percent_tokens(text, count, invalid_percent, 22);
+        std::vector<int> values(count);
+        std::vector<std::uint64_t> offsets(count);
+        std::vector<std::uint16_t> fields(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            offsets[i] = static_cast<std::uint64_t>(tokens[i].data() - text.data());
+            fields[i] = static_cast<std::uint16_t>(i % 8);
+        }
+        ErrorSink sink(storage);
+
+        auto ns_per_field = [&](auto &&parse_all)
+        {
+            long long sink_value = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r)
+            {
+                sink_value += parse_all();
+            }
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            volatile long long keep = sink_value;
+            (void)keep;
+            return elapsed.count() / (count * reps);
+        };
+
+        const double plain = ns_per_field(
+            [&]
+            {
+                std::array<std::uint64_t, parse_err_count> counts{};
+                std::uint64_t located = 0;
+                long long sum = 0;
+                for (std::size_t i = 0; i < tokens.size(); ++i)
+                {
+                    const auto value = parse_percent(tokens[i]);
+                    if (value) [[likely]]
+                    {
+                        sum += *value;
+                    }
+                    else
+                    {
+                        ++counts[static_cast<std::size_t>(value.error())];
+                        located += offsets[i] + fields[i];
+                    }
+                }
+                return sum + static_cast<long long>(counts[0] + counts[1] + counts[2] + located);
+            });
+        const double with_sink = ns_per_field(
+            [&]
+            {
+                sink.clear();
+                long long sum = 0;
+                for (std::size_t i = 0; i < tokens.size(); ++i)
+                {
+                    const auto value = parse_percent_field(tokens[i], offsets[i], fields[i]);
+                    if (value) [[likely]]
+                    {
+                        sum += *value;
+                    }
+                    else
+                    {
+                        sink.record(value.error());
+                    }
+                }
+                return sum + static_cast<long long>(sink.total());
+            });
+        const double records = ns_per_field(
+            [&]
+            {
+                sink.clear();
+                const std::size_t fields = parse_percent_records(text, values, sink);
+                return static_cast<long long>(fields + sink.total()) + values[fields / 2];
+            });
+        std::printf("%7d%% %14.2f %14.2f %14.2f\n", invalid_percent, plain, with_sink, records);
+    }
+}
+
+int main(int argc, char **argv)
 {
     // Valid cases
     assert(parse_percent("0%").value() == 0);
@@ -137,5 +709,70 @@ int main()
     assert(parse_percent("abc%").error() == ParseErr::bad_format);
     assert(parse_percent("101%").error() == ParseErr::out_of_range);
 
+    // Leading zeros, the shape checks around '%' and the size limits.
+    assert(parse_percent("007%").value() == 7);
+    assert(parse_percent("100%%").error() == ParseErr::bad_format);
+    assert(parse_percent("1000%").error() == ParseErr::bad_format);
+    assert(parse_percent("%").error() == ParseErr::bad_format);
+    assert(parse_percent("%5").error() == ParseErr::bad_format);
+    assert(parse_percent("999%").error() == ParseErr::out_of_range);
+
+    // Batch: parallel value / error spans.
+    const std::string_view batch_tokens[] = {"50%", "", "12", "200%", "100%"};
+    int batch_values[std::size(batch_tokens)];
+    ParseErr batch_errors[std::size(batch_tokens)];
+    assert(parse_percent_batch(batch_tokens, batch_values, batch_errors) == 3);
+    assert(batch_values[0] == 50 && batch_values[4] == 100);
+    assert(batch_values[1] == -1 && batch_errors[1] == ParseErr::empty);
+    assert(batch_values[2] == -1 && batch_errors[2] == ParseErr::bad_format);
+    assert(batch_values[3] == -1 && batch_errors[3] == ParseErr::out_of_range);
+
+    check_matches_reference();
+
+    // Structured errors: code, byte offset and field index survive the round trip.
+    const ParseError packed(ParseErr::bad_format, 40'000'000'123, 7);
+    assert(packed.code() == ParseErr::bad_format && packed.offset() == 40'000'000'123 && packed.field() == 7);
+    assert(parse_percent_field("42%", 10, 2).value() == 42);
+    assert(parse_percent_field("42", 10, 2).error() == ParseError(ParseErr::bad_format, 10, 2));
+    assert(parse_percent_field("", 0, 0).error().code() == ParseErr::empty);
+
+    {
+        // Records: line 1 fails on field 2, line 2 on fields 0 and 1 (the sink keeps two).
+        constexpr std::string_view text = "5%,10%,x%\n101%,,100%\n7%";
+        std::array<ParseError, 2> storage;
+        ErrorSink errors(storage);
+        int values[7];
+        const std::size_t allocations = allocation_count;
+        assert(parse_percent_records(text, values, errors) == 7);
+        assert(allocation_count == allocations && "Error reporting must not allocate");
+
+        const int expected_values[] = {5, 10, -1, -1, -1, 100, 7};
+        assert(std::equal(std::begin(values), std::end(values), std::begin(expected_values)));
+        assert(errors.total() == 3 && errors.count(ParseErr::bad_format) == 1 && errors.count(ParseErr::empty) == 1 &&
+               errors.count(ParseErr::out_of_range) == 1);
+        assert(errors.first().size() == 2);
+        assert(errors.first()[0] == ParseError(ParseErr::bad_format, 7, 2));
+        assert(errors.first()[1] == ParseError(ParseErr::out_of_range, 10, 0));
+
+        errors.clear();
+        assert(errors.total() == 0 && errors.first().empty());
+
+        // Trailing separators: a final ',' still ends in an empty field, a final '\n' does not.
+        assert(parse_percent_records("5%,", values, errors) == 2 && values[0] == 5 && values[1] == -1);
+        assert(parse_percent_records("5%,\n", values, errors) == 2 && values[1] == -1);
+        assert(parse_percent_records("5%\n\n7%\n", values, errors) == 3 && values[1] == -1 && values[2] == 7);
+        assert(parse_percent_records("5%\n", values, errors) == 1);
+        assert(parse_percent_records("", values, errors) == 0);
+        assert(errors.total() == 3 && errors.count(ParseErr::empty) == 3);
+        assert(errors.first()[0] == ParseError(ParseErr::empty, 3, 1));
+        assert(errors.first()[1] == ParseError(ParseErr::empty, 3, 1));
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+        bench_error_reporting();
+    }
+
     return 0;
 }
\ No newline at end of file
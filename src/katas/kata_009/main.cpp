@@ -1,7 +1,32 @@
 
+#include <algorithm>
 #include <array>
+#include <barrier>
 #include <span>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC / Clang need a per-function target to emit AVX2 in a baseline x86-64 build; MSVC does not.
+#if defined(__GNUC__) || defined(__clang__)
+#define KATA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define KATA_TARGET_AVX2
+#endif
 
 /*
 Task
@@ -61,18 +86,47 @@ Use std::span
 No frameworks
 No extra helpers beyond standard headers
 
+Fast path
+
+min / max is one vectorized pass (SSE2 or AVX2 lanes, reduced at the end),
+then each element becomes min((x - min) * inv_range, 1) with inv_range = 1 / (max - min)
+precomputed once. The clamp keeps max -> exactly 1 when the reciprocal rounds up;
+x == min gives exactly 0. Every level (scalar, SSE2, AVX2) uses the same per-element
+operations, so all of them produce the same bits. NaN inputs are unspecified.
+
+The AVX2 kernels are compiled with a function-level target and picked at runtime,
+so one binary runs on any x86-64 machine. Other architectures use the scalar kernels.
+
+Large spans: normalize_0_1(xs, ParallelPolicy{...}) splits the span into
+cache-line-aligned chunks, reduces min / max and scales the chunks on several
+threads. Spans below the policy's serial_threshold take the serial path.
+
+Run with --bench to compare against the original divide loop from 16 floats to 64 MB,
+and thread scaling on 256 MB.
+
 */
 
-bool normalize_0_1(std::span<float> xs)
+enum class SimdLevel
+{
+    scalar,
+    sse2,
+    avx2
+};
+
+struct MinMax
+{
+    float min;
+    float max;
+};
+
+// Original two-pass divide implementation; kept as the benchmark baseline.
+bool normalize_0_1_divide(std::span<float> xs)
 {
-    // Returns false if input is empty or max == min
     if (xs.empty())
         return false;
 
     float min = xs[0];
     float max = xs[0];
-
-    // Find min and max    
     for (float x : xs)
     {
         if (x < min)
@@ -81,23 +135,369 @@ bool normalize_0_1(std::span<float> xs)
             max = x;
     }
 
-    // Check if max equals min
     if (max == min)
         return false;
 
     float range = max - min;
-
-    // Normalize in-place
     for (float& x : xs)
     {
         x = (x - min) / range;
     }
+    return true;
+}
+
+MinMax min_max_scalar(std::span<const float> xs)
+{
+    MinMax r{xs[0], xs[0]};
+    for (float x : xs)
+    {
+        r.min = std::min(r.min, x);
+        r.max = std::max(r.max, x);
+    }
+    return r;
+}
+
+void scale_scalar(std::span<float> xs, float min, float inv_range)
+{
+    for (float& x : xs)
+    {
+        x = std::min((x - min) * inv_range, 1.f);
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+// SSE2 is part of the x86-64 baseline, no dispatch needed.
+MinMax min_max_sse2(std::span<const float> xs)
+{
+    const float* p = xs.data();
+    const std::size_t n = xs.size();
+    std::size_t i = 0;
+
+    // Two accumulator pairs hide the min / max latency.
+    __m128 min0 = _mm_set1_ps(p[0]);
+    __m128 max0 = min0;
+    __m128 min1 = min0;
+    __m128 max1 = min0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128 a = _mm_loadu_ps(p + i);
+        const __m128 b = _mm_loadu_ps(p + i + 4);
+        min0 = _mm_min_ps(min0, a);
+        max0 = _mm_max_ps(max0, a);
+        min1 = _mm_min_ps(min1, b);
+        max1 = _mm_max_ps(max1, b);
+    }
+
+    alignas(16) float lo[4];
+    alignas(16) float hi[4];
+    _mm_store_ps(lo, _mm_min_ps(min0, min1));
+    _mm_store_ps(hi, _mm_max_ps(max0, max1));
+
+    MinMax r{lo[0], hi[0]};
+    for (int k = 1; k < 4; ++k)
+    {
+        r.min = std::min(r.min, lo[k]);
+        r.max = std::max(r.max, hi[k]);
+    }
+    for (; i < n; ++i)
+    {
+        r.min = std::min(r.min, p[i]);
+        r.max = std::max(r.max, p[i]);
+    }
+    return r;
+}
+
+void scale_sse2(std::span<float> xs, float min, float inv_range)
+{
+    float* p = xs.data();
+    const std::size_t n = xs.size();
+    std::size_t i = 0;
+
+    const __m128 vmin = _mm_set1_ps(min);
+    const __m128 vinv = _mm_set1_ps(inv_range);
+    const __m128 one = _mm_set1_ps(1.f);
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128 v = _mm_sub_ps(_mm_loadu_ps(p + i), vmin);
+        _mm_storeu_ps(p + i, _mm_min_ps(_mm_mul_ps(v, vinv), one));
+    }
+    scale_scalar(xs.subspan(i), min, inv_range);
+}
+
+KATA_TARGET_AVX2 MinMax min_max_avx2(std::span<const float> xs)
+{
+    const float* p = xs.data();
+    const std::size_t n = xs.size();
+    std::size_t i = 0;
+
+    __m256 min0 = _mm256_set1_ps(p[0]);
+    __m256 max0 = min0;
+    __m256 min1 = min0;
+    __m256 max1 = min0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m256 a = _mm256_loadu_ps(p + i);
+        const __m256 b = _mm256_loadu_ps(p + i + 8);
+        min0 = _mm256_min_ps(min0, a);
+        max0 = _mm256_max_ps(max0, a);
+        min1 = _mm256_min_ps(min1, b);
+        max1 = _mm256_max_ps(max1, b);
+    }
+
+    alignas(32) float lo[8];
+    alignas(32) float hi[8];
+    _mm256_store_ps(lo, _mm256_min_ps(min0, min1));
+    _mm256_store_ps(hi, _mm256_max_ps(max0, max1));
+
+    MinMax r{lo[0], hi[0]};
+    for (int k = 1; k < 8; ++k)
+    {
+        r.min = std::min(r.min, lo[k]);
+        r.max = std::max(r.max, hi[k]);
+    }
+    for (; i < n; ++i)
+    {
+        r.min = std::min(r.min, p[i]);
+        r.max = std::max(r.max, p[i]);
+    }
+    return r;
+}
+
+KATA_TARGET_AVX2 void scale_avx2(std::span<float> xs, float min, float inv_range)
+{
+    float* p = xs.data();
+    const std::size_t n = xs.size();
+    std::size_t i = 0;
+
+    const __m256 vmin = _mm256_set1_ps(min);
+    const __m256 vinv = _mm256_set1_ps(inv_range);
+    const __m256 one = _mm256_set1_ps(1.f);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 v = _mm256_sub_ps(_mm256_loadu_ps(p + i), vmin);
+        _mm256_storeu_ps(p + i, _mm256_min_ps(_mm256_mul_ps(v, vinv), one));
+    }
+    scale_scalar(xs.subspan(i), min, inv_range);
+}
+
+bool cpu_has_avx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false; // OS does not save YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+SimdLevel best_simd_level()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    static const SimdLevel level = cpu_has_avx2() ? SimdLevel::avx2 : SimdLevel::sse2;
+    return level;
+#else
+    return SimdLevel::scalar;
+#endif
+}
+
+MinMax min_max(std::span<const float> xs, SimdLevel level)
+{
+    switch (level)
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+    case SimdLevel::avx2:
+        return min_max_avx2(xs);
+    case SimdLevel::sse2:
+        return min_max_sse2(xs);
+#endif
+    default:
+        return min_max_scalar(xs);
+    }
+}
+
+void scale(std::span<float> xs, float min, float inv_range, SimdLevel level)
+{
+    switch (level)
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+    case SimdLevel::avx2:
+        scale_avx2(xs, min, inv_range);
+        break;
+    case SimdLevel::sse2:
+        scale_sse2(xs, min, inv_range);
+        break;
+#endif
+    default:
+        scale_scalar(xs, min, inv_range);
+        break;
+    }
+}
+
+// Runs with the requested kernels; a level the machine lacks falls back to the best available.
+bool normalize_0_1(std::span<float> xs, SimdLevel level)
+{
+    if (xs.empty())
+        return false;
+
+    level = std::min(level, best_simd_level());
+
+    const MinMax mm = min_max(xs, level);
+    if (mm.max == mm.min)
+        return false;
 
+    scale(xs, mm.min, 1.f / (mm.max - mm.min), level);
     return true;
 }
 
+// Spans shorter than serial_threshold floats stay on the calling thread
+// (the default, 256K floats = 1 MB, is about one L2).
+struct ParallelPolicy
+{
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t serial_threshold = std::size_t{1} << 18;
+};
+
+// Splits xs at 64-byte-aligned addresses so no two threads write the same cache line,
+// reduces per-chunk min / max in parallel, then scales each chunk on its own thread.
+// Same kernels as the serial path, so the result is bit-identical.
+bool normalize_0_1(std::span<float> xs, const ParallelPolicy& policy)
+{
+    constexpr std::size_t line_floats = 64 / sizeof(float);
+
+    // Empty spans take the serial path too: there would be no chunk for the calling thread.
+    if (xs.empty() || xs.size() < policy.serial_threshold || policy.threads < 2)
+        return normalize_0_1(xs, best_simd_level());
+
+    const SimdLevel level = best_simd_level();
+    const std::size_t n = xs.size();
+
+    // First float that starts a cache line, then equal line-multiple chunks from there.
+    const auto address = reinterpret_cast<std::uintptr_t>(xs.data());
+    const std::size_t head = std::min(n, ((64 - address % 64) % 64) / sizeof(float));
+    const std::size_t per_chunk = ((n - head) / policy.threads + line_floats) / line_floats * line_floats;
+
+    std::vector<std::span<float>> chunks;
+    for (std::size_t begin = 0; begin < n;)
+    {
+        const std::size_t end = std::min(n, chunks.empty() ? head + per_chunk : begin + per_chunk);
+        chunks.push_back(xs.subspan(begin, end - begin));
+        begin = end;
+    }
+
+    // One line per partial result so the reduction phase does not false-share.
+    struct alignas(64) Partial
+    {
+        MinMax mm;
+    };
+    std::vector<Partial> partials(chunks.size());
+
+    float min = 0.f;
+    float inv_range = 0.f;
+    bool ok = false;
+    auto reduce = [&]() noexcept
+    {
+        MinMax mm = partials[0].mm;
+        for (const Partial& p : partials)
+        {
+            mm.min = std::min(mm.min, p.mm.min);
+            mm.max = std::max(mm.max, p.mm.max);
+        }
+        ok = mm.max != mm.min;
+        min = mm.min;
+        inv_range = ok ? 1.f / (mm.max - mm.min) : 0.f;
+    };
+    std::barrier sync(static_cast<std::ptrdiff_t>(chunks.size()), reduce);
+
+    auto work = [&](std::size_t k)
+    {
+        partials[k].mm = min_max(chunks[k], level);
+        sync.arrive_and_wait();
+        if (ok)
+            scale(chunks[k], min, inv_range, level);
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t k = 1; k < chunks.size(); ++k)
+            workers.emplace_back(work, k);
+        work(0);
+    }
+    return ok;
+}
+
+bool normalize_0_1(std::span<float> xs)
+{
+    return normalize_0_1(xs, best_simd_level());
+}
+
+template <class Fn>
+double gb_per_s(std::vector<float>& data, std::size_t n, Fn&& fn)
+{
+    // Roughly 64 MB of input per measurement, at least one call.
+    const std::size_t reps = std::max<std::size_t>(1, (std::size_t{64} << 20) / n);
+    std::span<float> xs(data.data(), n);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < reps; ++r)
+    {
+        fn(xs);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(reps * n * sizeof(float)) / elapsed.count() / 1e9;
+}
+
+void run_benchmarks()
+{
+    constexpr std::size_t max_floats = (std::size_t{64} << 20) / sizeof(float);
+    std::vector<float> data(max_floats);
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> dist(-1000.f, 1000.f);
+    for (float& x : data)
+        x = dist(rng);
+
+    std::cout << "normalize_0_1 throughput (GB/s of input), best level: "
+              << (best_simd_level() == SimdLevel::avx2 ? "avx2" : best_simd_level() == SimdLevel::sse2 ? "sse2" : "scalar")
+              << "\n";
+    for (std::size_t n = 16; n <= max_floats; n *= 16)
+    {
+        // Each call leaves values in [0, 1]; the next call still sees max > min.
+        std::cout << "  " << n * sizeof(float) << " bytes:"
+                  << " divide " << gb_per_s(data, n, [](std::span<float> xs) { normalize_0_1_divide(xs); })
+                  << ", scalar " << gb_per_s(data, n, [](std::span<float> xs) { normalize_0_1(xs, SimdLevel::scalar); })
+                  << ", sse2 " << gb_per_s(data, n, [](std::span<float> xs) { normalize_0_1(xs, SimdLevel::sse2); })
+                  << ", avx2 " << gb_per_s(data, n, [](std::span<float> xs) { normalize_0_1(xs, SimdLevel::avx2); })
+                  << "\n";
+    }
+    data = {};
+
+    // Thread scaling on a 256 MB span, well past any L2 / L3.
+    constexpr std::size_t big_floats = (std::size_t{256} << 20) / sizeof(float);
+    std::vector<float> big(big_floats);
+    for (std::size_t i = 0; i < big.size(); ++i)
+        big[i] = static_cast<float>(i % 1000);
+
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << "parallel normalize_0_1, 256 MB\n";
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const ParallelPolicy policy{threads, 0};
+        const double rate = gb_per_s(big, big.size(), [&](std::span<float> xs) { normalize_0_1(xs, policy); });
+        std::cout << "  " << threads << " threads: " << rate << " GB/s\n";
+    }
+}
 
-int main()
+int main(int argc, char** argv)
 {
     // Test 1
     {
@@ -125,5 +525,64 @@ int main()
         assert(result == false);
     }
 
+    // Test 4: every SIMD level matches the scalar kernels bit for bit (odd size exercises the tails)
+    {
+        std::vector<float> input(1037);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dist(-50.f, 250.f);
+        for (float& x : input)
+            x = dist(rng);
+        input[17] = -75.f; // unique min
+        input[901] = 300.f; // unique max
+
+        std::vector<float> expected = input;
+        assert(normalize_0_1(expected, SimdLevel::scalar));
+        assert(expected[17] == 0.f);
+        assert(expected[901] == 1.f);
+
+        for (SimdLevel level : {SimdLevel::sse2, SimdLevel::avx2})
+        {
+            std::vector<float> actual = input;
+            assert(normalize_0_1(actual, level));
+            assert(std::memcmp(actual.data(), expected.data(), actual.size() * sizeof(float)) == 0);
+        }
+        assert(std::ranges::all_of(expected, [](float x) { return x >= 0.f && x <= 1.f; }));
+    }
+
+    // Test 5: parallel path matches the serial one bit for bit, including an unaligned start
+    {
+        std::vector<float> input(100'003);
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        for (float& x : input)
+            x = dist(rng);
+
+        for (std::size_t offset : {0, 1, 3})
+        {
+            std::vector<float> expected = input;
+            std::vector<float> actual = input;
+            std::span<float> serial = std::span<float>(expected).subspan(offset);
+            std::span<float> parallel = std::span<float>(actual).subspan(offset);
+
+            assert(normalize_0_1(serial));
+            assert(normalize_0_1(parallel, ParallelPolicy{4, 0}));
+            assert(std::memcmp(actual.data(), expected.data(), actual.size() * sizeof(float)) == 0);
+        }
+
+        std::vector<float> flat(50'000, 3.f);
+        assert(normalize_0_1(flat, ParallelPolicy{4, 0}) == false);
+        assert(normalize_0_1(std::span<float>{}, ParallelPolicy{4, 0}) == normalize_0_1(std::span<float>{}));
+
+        // Below the threshold: serial path, same answer.
+        std::array<float, 5> small{ 10.f, 20.f, 15.f, 20.f, 10.f };
+        assert(normalize_0_1(small, ParallelPolicy{4, 1024}));
+        assert(small[2] == 0.5f);
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+    }
+
     return 0;
 }
\ No newline at end of file
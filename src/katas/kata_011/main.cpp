@@ -1,5 +1,15 @@
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <vector>
 #include <ranges>
 #include <numeric>
@@ -65,14 +75,496 @@ C++23
 <ranges>, <vector>, <cassert>
 No frameworks
 No logging
+
+Streaming engine
+
+slide + fold_left re-sums every window: O(n * w). MovingAverage keeps a running
+sum over a ring of the last w samples instead: one add and one subtract per sample.
+The running sum uses Neumaier compensation by default so that add / subtract
+rounding does not drift over long feeds.
+
+push(x) returns the average once w samples have arrived; process(in, out) does the
+same over a whole span. custom::views::moving_average(w) is the lazy ranges form,
+built on the same compensated running sum.
+
+Windowed statistics
+
+WindowedStats<stat::mean | stat::variance | ...> shares one sample ring between
+the selected statistics: mean (compensated running sum), sample variance / stddev
+(sliding Welford), min / max (monotonic deques, amortized O(1) instead of
+rescanning each window) and an exponential moving average.
+
+Run with --bench to compare against the slide / fold_left pipeline, and for
+per-statistic throughput.
 */
 
-int main()
+// Running sum with optional Neumaier compensation: the low-order bits lost by each
+// addition are accumulated separately and folded back in by value().
+class RunningSum
 {
+public:
+    explicit RunningSum(bool compensated = true) : compensated_(compensated) {}
 
-    std::vector<double> input{1, 2, 3, 4, 5};
-    std::size_t window = 3;
+    void add(double x)
+    {
+        const double t = sum_ + x;
+        if (compensated_)
+        {
+            compensation_ += std::abs(sum_) >= std::abs(x) ? (sum_ - t) + x : (x - t) + sum_;
+        }
+        sum_ = t;
+    }
+
+    double value() const { return sum_ + compensation_; }
+
+    void reset()
+    {
+        sum_ = 0.0;
+        compensation_ = 0.0;
+    }
+
+private:
+    double sum_ = 0.0;
+    double compensation_ = 0.0;
+    bool compensated_ = true;
+};
+
+class MovingAverage
+{
+public:
+    explicit MovingAverage(std::size_t window, bool compensated = true);
+
+    // Average of the last window() samples, or nullopt while the first window is filling.
+    std::optional<double> push(double x);
+
+    // Pushes every sample of in; writes each produced average to out and returns how many.
+    // out needs room for in.size() values (fewer are written while the window fills).
+    std::size_t process(std::span<const double> in, std::span<double> out);
+
+    void reset();
+    std::size_t window() const;
+
+private:
+    std::vector<double> ring_;
+    std::size_t next_ = 0;  // ring slot the next sample overwrites
+    std::size_t count_ = 0; // samples seen, saturates at window
+    RunningSum sum_;
+};
+
+MovingAverage::MovingAverage(std::size_t window, bool compensated)
+    : ring_(window), sum_(compensated)
+{
+    assert(window > 0 && "Window must hold at least one sample");
+}
+
+std::optional<double> MovingAverage::push(double x)
+{
+    const std::size_t w = ring_.size();
+    if (count_ == w)
+    {
+        sum_.add(-ring_[next_]);
+    }
+    else
+    {
+        ++count_;
+    }
+
+    sum_.add(x);
+    ring_[next_] = x;
+    next_ = next_ + 1 == w ? 0 : next_ + 1;
+
+    if (count_ < w)
+    {
+        return std::nullopt;
+    }
+    return sum_.value() / static_cast<double>(w);
+}
+
+std::size_t MovingAverage::process(std::span<const double> in, std::span<double> out)
+{
+    assert(out.size() >= in.size() && "Output span too small");
+    const std::size_t w = ring_.size();
+    const double divisor = static_cast<double>(w);
+    std::size_t written = 0;
+    std::size_t i = 0;
+
+    // Filling: not every sample produces an average yet.
+    for (; i < in.size() && count_ < w; ++i)
+    {
+        if (const auto avg = push(in[i]))
+        {
+            out[written++] = *avg;
+        }
+    }
+
+    // Steady state: every sample replaces the oldest one and produces an average.
+    for (; i < in.size(); ++i)
+    {
+        const double x = in[i];
+        sum_.add(-ring_[next_]);
+        sum_.add(x);
+        ring_[next_] = x;
+        next_ = next_ + 1 == w ? 0 : next_ + 1;
+        out[written++] = sum_.value() / divisor;
+    }
+    return written;
+}
+
+void MovingAverage::reset()
+{
+    next_ = 0;
+    count_ = 0;
+    sum_.reset();
+}
+
+std::size_t MovingAverage::window() const
+{
+    return ring_.size();
+}
+
+// Statistics WindowedStats can maintain; combine with |.
+namespace stat
+{
+    enum : unsigned
+    {
+        mean = 1u << 0,     // compensated running sum / w
+        variance = 1u << 1, // sliding Welford, sample variance (w - 1)
+        minmax = 1u << 2,   // monotonic deques, amortized O(1)
+        ema = 1u << 3,      // exponential moving average over every sample seen
+        all = mean | variance | minmax | ema,
+    };
+}
 
+// Fields of statistics not selected in WindowedStats<Stats> stay 0.
+struct WindowStats
+{
+    double mean = 0.0;
+    double variance = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double ema = 0.0;
+};
+
+// Fixed-capacity deque of (sequence, value) kept monotonic: front is the window's
+// extremum, older entries that can never become the extremum are dropped on push.
+template <class Compare>
+class MonotonicDeque
+{
+public:
+    explicit MonotonicDeque(std::size_t capacity) : items_(capacity) {}
+
+    void push(std::uint64_t sequence, double value)
+    {
+        while (size_ > 0 && !Compare{}(back().value, value))
+        {
+            --size_;
+        }
+        items_[wrap(head_ + size_)] = {sequence, value};
+        ++size_;
+    }
+
+    // Drops the front if it is older than `oldest`.
+    void expire(std::uint64_t oldest)
+    {
+        if (size_ > 0 && items_[head_].sequence < oldest)
+        {
+            head_ = head_ + 1 == items_.size() ? 0 : head_ + 1;
+            --size_;
+        }
+    }
+
+    double front() const { return items_[head_].value; }
+
+private:
+    struct Item
+    {
+        std::uint64_t sequence;
+        double value;
+    };
+
+    const Item &back() const { return items_[wrap(head_ + size_ - 1)]; }
+
+    // index < 2 * capacity here, so one compare replaces a modulo.
+    std::size_t wrap(std::size_t index) const { return index >= items_.size() ? index - items_.size() : index; }
+
+    std::vector<Item> items_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+// Several rolling statistics over one shared ring of the last w samples, in one pass.
+// Stats is a stat:: bitmask; unselected statistics cost nothing.
+template <unsigned Stats>
+class WindowedStats
+{
+public:
+    explicit WindowedStats(std::size_t window, double ema_alpha = 0.1);
+
+    // Statistics of the last window() samples, or nullopt while the first window is filling.
+    std::optional<WindowStats> push(double x);
+
+    // Same as MovingAverage::process: out needs room for in.size() results.
+    std::size_t process(std::span<const double> in, std::span<WindowStats> out);
+
+    std::size_t window() const;
+
+private:
+    void update(double x);
+    WindowStats current() const;
+
+    std::vector<double> ring_;
+    std::size_t next_ = 0;
+    std::uint64_t count_ = 0; // samples seen, never saturates (deque sequence numbers)
+
+    RunningSum sum_;
+    double welford_mean_ = 0.0;
+    double m2_ = 0.0;
+    MonotonicDeque<std::greater<double>> max_;
+    MonotonicDeque<std::less<double>> min_;
+    double alpha_;
+    double ema_ = 0.0;
+};
+
+template <unsigned Stats>
+WindowedStats<Stats>::WindowedStats(std::size_t window, double ema_alpha)
+    : ring_(window), max_(window), min_(window), alpha_(ema_alpha)
+{
+    assert(window > 0 && "Window must hold at least one sample");
+    assert(ema_alpha > 0.0 && ema_alpha <= 1.0);
+}
+
+template <unsigned Stats>
+std::optional<WindowStats> WindowedStats<Stats>::push(double x)
+{
+    update(x);
+    if (count_ < ring_.size())
+    {
+        return std::nullopt;
+    }
+    return current();
+}
+
+template <unsigned Stats>
+void WindowedStats<Stats>::update(double x)
+{
+    const std::size_t w = ring_.size();
+    const bool full = count_ >= w;
+    const double old = ring_[next_];
+
+    if constexpr ((Stats & stat::mean) != 0)
+    {
+        if (full)
+        {
+            sum_.add(-old);
+        }
+        sum_.add(x);
+    }
+    if constexpr ((Stats & stat::variance) != 0)
+    {
+        if (full)
+        {
+            // Replace old with x: mean shifts by (x - old) / w.
+            const double previous = welford_mean_;
+            welford_mean_ += (x - old) / static_cast<double>(w);
+            m2_ += (x - old) * ((x - welford_mean_) + (old - previous));
+        }
+        else
+        {
+            const double delta = x - welford_mean_;
+            welford_mean_ += delta / static_cast<double>(count_ + 1);
+            m2_ += delta * (x - welford_mean_);
+        }
+    }
+    if constexpr ((Stats & stat::minmax) != 0)
+    {
+        const std::uint64_t oldest = count_ + 1 > w ? count_ + 1 - w : 0;
+        max_.expire(oldest);
+        min_.expire(oldest);
+        max_.push(count_, x);
+        min_.push(count_, x);
+    }
+    if constexpr ((Stats & stat::ema) != 0)
+    {
+        ema_ = count_ == 0 ? x : ema_ + alpha_ * (x - ema_);
+    }
+
+    ring_[next_] = x;
+    next_ = next_ + 1 == w ? 0 : next_ + 1;
+    ++count_;
+}
+
+template <unsigned Stats>
+std::size_t WindowedStats<Stats>::process(std::span<const double> in, std::span<WindowStats> out)
+{
+    assert(out.size() >= in.size() && "Output span too small");
+    std::size_t written = 0;
+    for (double x : in)
+    {
+        update(x);
+        if (count_ >= ring_.size())
+        {
+            out[written++] = current();
+        }
+    }
+    return written;
+}
+
+template <unsigned Stats>
+std::size_t WindowedStats<Stats>::window() const
+{
+    return ring_.size();
+}
+
+template <unsigned Stats>
+WindowStats WindowedStats<Stats>::current() const
+{
+    const double w = static_cast<double>(ring_.size());
+    WindowStats s;
+    if constexpr ((Stats & stat::mean) != 0)
+    {
+        s.mean = sum_.value() / w;
+    }
+    if constexpr ((Stats & stat::variance) != 0)
+    {
+        // Rounding can push m2 slightly below zero on constant input.
+        s.variance = ring_.size() > 1 ? std::max(m2_, 0.0) / (w - 1.0) : 0.0;
+        s.stddev = std::sqrt(s.variance);
+    }
+    if constexpr ((Stats & stat::minmax) != 0)
+    {
+        s.min = min_.front();
+        s.max = max_.front();
+    }
+    if constexpr ((Stats & stat::ema) != 0)
+    {
+        s.ema = ema_;
+    }
+    return s;
+}
+
+namespace custom
+{
+    // Lazy moving average over a forward range. Instead of a ring, the iterator keeps a
+    // trailing iterator w elements behind and re-reads the sample leaving the window.
+    template <std::ranges::forward_range V>
+        requires std::ranges::view<V>
+    class moving_average_view : public std::ranges::view_interface<moving_average_view<V>>
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = double;
+            using difference_type = std::ptrdiff_t;
+            using reference = double;
+            using pointer = void;
+
+            iterator() = default;
+
+            // Begin: sums the first window; lands on end if the input is shorter.
+            iterator(V &base, std::size_t window)
+                : trail_(std::ranges::begin(base)), lead_(trail_), end_(std::ranges::end(base)), window_(window)
+            {
+                for (std::size_t i = 0; i < window_; ++i, ++lead_)
+                {
+                    if (lead_ == end_)
+                    {
+                        done_ = true;
+                        return;
+                    }
+                    sum_.add(*lead_);
+                }
+            }
+
+            // End.
+            explicit iterator(std::size_t window) : window_(window), done_(true) {}
+
+            double operator*() const { return sum_.value() / static_cast<double>(window_); }
+
+            iterator &operator++()
+            {
+                if (lead_ == end_)
+                {
+                    done_ = true;
+                    return *this;
+                }
+                sum_.add(-*trail_);
+                sum_.add(*lead_);
+                ++lead_;
+                ++trail_;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            friend bool operator==(const iterator &a, const iterator &b)
+            {
+                if (a.done_ || b.done_)
+                {
+                    return a.done_ == b.done_;
+                }
+                return a.trail_ == b.trail_;
+            }
+
+        private:
+            std::ranges::iterator_t<V> trail_{}; // first sample of the window
+            std::ranges::iterator_t<V> lead_{};  // one past the last sample
+            std::ranges::sentinel_t<V> end_{};
+            std::size_t window_ = 1;
+            RunningSum sum_;
+            bool done_ = false;
+        };
+
+        moving_average_view() = default;
+        moving_average_view(V base, std::size_t window) : base_(std::move(base)), window_(window)
+        {
+            assert(window > 0 && "Window must hold at least one sample");
+        }
+
+        iterator begin() { return iterator(base_, window_); }
+        iterator end() { return iterator(window_); }
+
+    private:
+        V base_{};
+        std::size_t window_ = 1;
+    };
+
+    template <class R>
+    moving_average_view(R &&, std::size_t) -> moving_average_view<std::views::all_t<R>>;
+
+    namespace views
+    {
+        struct moving_average_adaptor
+        {
+            std::size_t window;
+
+            template <std::ranges::viewable_range R>
+            friend auto operator|(R &&r, moving_average_adaptor a)
+            {
+                return moving_average_view(std::views::all(std::forward<R>(r)), a.window);
+            }
+        };
+
+        // input | custom::views::moving_average(w)
+        inline constexpr auto moving_average = [](std::size_t window)
+        {
+            return moving_average_adaptor{window};
+        };
+    }
+}
+
+#if defined(__cpp_lib_ranges_slide)
+// Original kata pipeline: re-sums each window. Kept as the benchmark baseline.
+std::vector<double> moving_average_slide(std::span<const double> input, std::size_t window)
+{
     auto avg_window = [window](auto const& w) {
         const double sum = custom::fold_left(w, 0.0, std::plus<double>{});
         return sum / static_cast<double>(window);
@@ -81,9 +573,215 @@ int main()
     auto windows = input | std::views::slide(window);
     auto moving_averages = windows | std::views::transform(avg_window);
 
-    std::vector<double> output(moving_averages.begin(), moving_averages.end());
+    return std::vector<double>(moving_averages.begin(), moving_averages.end());
+}
+#endif
+
+template <class Fn>
+double ns_per_sample(std::size_t samples, Fn &&fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(samples);
+}
+
+void run_benchmarks()
+{
+    constexpr std::size_t window = 1000;
+    constexpr std::size_t samples = 10'000'000;
 
-    assert((output == std::vector<double>{2.0, 3.0, 4.0}));
+    std::vector<double> feed(samples);
+    for (std::size_t i = 0; i < samples; ++i)
+    {
+        feed[i] = static_cast<double>((i * 7919) % 1000) * 0.25;
+    }
+    std::vector<double> out(samples);
+    double sink = 0.0;
+
+    std::cout << "Moving average, window " << window << "\n";
+    std::cout << "  engine process (" << samples << " samples): " << ns_per_sample(samples, [&]
+    {
+        MovingAverage avg(window);
+        sink += static_cast<double>(avg.process(feed, out));
+    }) << " ns/sample\n";
+    std::cout << "  engine, uncompensated: " << ns_per_sample(samples, [&]
+    {
+        MovingAverage avg(window, false);
+        sink += static_cast<double>(avg.process(feed, out));
+    }) << " ns/sample\n";
+    std::cout << "  views::moving_average: " << ns_per_sample(samples, [&]
+    {
+        for (double v : feed | custom::views::moving_average(window))
+        {
+            sink += v;
+        }
+    }) << " ns/sample\n";
+
+#if defined(__cpp_lib_ranges_slide)
+    // O(n * w): a tenth of the feed is enough to measure it.
+    constexpr std::size_t slide_samples = samples / 10;
+    std::cout << "  slide + fold_left (" << slide_samples << " samples): " << ns_per_sample(slide_samples, [&]
+    {
+        sink += moving_average_slide(std::span(feed).first(slide_samples), window).back();
+    }) << " ns/sample\n";
+#else
+    std::cout << "  slide + fold_left: std::views::slide not available in this standard library\n";
+#endif
+
+    std::vector<WindowStats> stats(samples);
+    auto stats_ns = [&](auto engine)
+    {
+        return ns_per_sample(samples, [&]
+        {
+            sink += static_cast<double>(engine.process(feed, stats));
+        });
+    };
+    std::cout << "Windowed statistics, window " << window << "\n";
+    std::cout << "  mean    : " << stats_ns(WindowedStats<stat::mean>(window)) << " ns/sample\n";
+    std::cout << "  variance: " << stats_ns(WindowedStats<stat::variance>(window)) << " ns/sample\n";
+    std::cout << "  min/max : " << stats_ns(WindowedStats<stat::minmax>(window)) << " ns/sample\n";
+    std::cout << "  ema     : " << stats_ns(WindowedStats<stat::ema>(window)) << " ns/sample\n";
+    std::cout << "  all     : " << stats_ns(WindowedStats<stat::all>(window)) << " ns/sample\n";
+
+    std::cout << "  (checksum " << sink << ")\n";
+}
+
+int main(int argc, char **argv)
+{
+
+    std::vector<double> input{1, 2, 3, 4, 5};
+    std::size_t window = 3;
+    const std::vector<double> expected{2.0, 3.0, 4.0};
+
+    // Incremental.
+    {
+        MovingAverage avg(window);
+        assert(!avg.push(1.0) && !avg.push(2.0) && "No average until the window is full");
+        assert(avg.push(3.0) == 2.0);
+        assert(avg.push(4.0) == 3.0);
+        assert(avg.push(5.0) == 4.0);
+    }
+
+    // Bulk.
+    {
+        MovingAverage avg(window);
+        std::vector<double> output(input.size());
+        output.resize(avg.process(input, output));
+        assert(output == expected);
+    }
+
+    // Lazy view.
+    {
+        auto moving_averages = input | custom::views::moving_average(window);
+        std::vector<double> output(moving_averages.begin(), moving_averages.end());
+        assert(output == expected);
+
+        auto too_short = std::views::take(input, 2) | custom::views::moving_average(window);
+        assert(too_short.begin() == too_short.end());
+    }
+
+#if defined(__cpp_lib_ranges_slide)
+    assert(moving_average_slide(input, window) == expected);
+#endif
+
+    // Engine and view perform the same operations in the same order: identical results.
+    {
+        std::vector<double> feed(10'000);
+        for (std::size_t i = 0; i < feed.size(); ++i)
+        {
+            feed[i] = static_cast<double>((i * 7919) % 1000) * 0.1;
+        }
+
+        MovingAverage avg(64);
+        std::vector<double> bulk(feed.size());
+        bulk.resize(avg.process(feed, bulk));
+
+        auto lazy = feed | custom::views::moving_average(64);
+        assert(bulk == std::vector<double>(lazy.begin(), lazy.end()));
+    }
+
+    // Windowed statistics against a naive per-window recomputation.
+    {
+        constexpr std::size_t w = 37;
+        constexpr double alpha = 0.2;
+        std::vector<double> feed(5'000);
+        for (std::size_t i = 0; i < feed.size(); ++i)
+        {
+            // Mix of trends, repeats and spikes to exercise the deques.
+            feed[i] = static_cast<double>((i * 7919) % 113) - 0.5 * static_cast<double>(i % 11) + (i % 97 == 0 ? 500.0 : 0.0);
+        }
+
+        WindowedStats<stat::all> engine(w, alpha);
+        std::vector<WindowStats> out(feed.size());
+        out.resize(engine.process(feed, out));
+        assert(out.size() == feed.size() - w + 1);
+
+        double ema = feed[0];
+        for (std::size_t i = 1; i < w - 1; ++i)
+        {
+            ema += alpha * (feed[i] - ema);
+        }
+        for (std::size_t k = 0; k < out.size(); ++k)
+        {
+            const auto window_samples = std::span(feed).subspan(k, w);
+            double sum = 0.0;
+            for (double x : window_samples)
+            {
+                sum += x;
+            }
+            const double mean = sum / static_cast<double>(w);
+            double squares = 0.0;
+            for (double x : window_samples)
+            {
+                squares += (x - mean) * (x - mean);
+            }
+            const double variance = squares / static_cast<double>(w - 1);
+            ema += alpha * (feed[k + w - 1] - ema);
+
+            assert(std::abs(out[k].mean - mean) <= 1e-9 * std::max(1.0, std::abs(mean)));
+            assert(std::abs(out[k].variance - variance) <= 1e-9 * std::max(1.0, variance));
+            assert(out[k].min == std::ranges::min(window_samples));
+            assert(out[k].max == std::ranges::max(window_samples));
+            assert(out[k].ema == ema);
+        }
+
+        // Selecting a subset leaves the other fields at zero and the selected ones unchanged.
+        WindowedStats<stat::minmax> only_minmax(w);
+        std::vector<WindowStats> partial(feed.size());
+        partial.resize(only_minmax.process(feed, partial));
+        assert(partial.back().max == out.back().max && partial.back().mean == 0.0);
+    }
+
+    // Long feed with a large offset: compensated running sum matches a fresh re-sum of the last window.
+    {
+        constexpr std::size_t long_window = 1000;
+        MovingAverage avg(long_window);
+        std::vector<double> recent;
+        double last = 0.0;
+        for (std::size_t i = 0; i < 1'000'000; ++i)
+        {
+            const double x = 1e9 + static_cast<double>(i % 97) * 0.001 - (i % 2 ? 1e9 : 0.0);
+            if (const auto v = avg.push(x))
+            {
+                last = *v;
+            }
+            recent.push_back(x);
+        }
+
+        RunningSum fresh;
+        for (double x : std::span(recent).last(long_window))
+        {
+            fresh.add(x);
+        }
+        const double reference = fresh.value() / static_cast<double>(long_window);
+        assert(std::abs(last - reference) <= 1e-9 * std::abs(reference));
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--bench")
+    {
+        run_benchmarks();
+    }
 
     return 0;
-}
\ No newline at end of file
+}